@@ -34,22 +34,36 @@
 int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
     buffer_t buf = {.ptr = data, .size = size, .offset = 0};
     transaction_input_t txin;
+    transaction_input_t txin_record;
     parser_status_e status;
     char address_type[2] = {0};
     char address_index[5] = {0};
-    char sequence[9] = {0};
     char value[9] = {0};
     char tx_id[33] = {0};
     char index[2] = {0};
 
     memset(&txin, 0, sizeof(txin));
+    memset(&txin_record, 0, sizeof(txin_record));
 
     status = transaction_input_deserialize(&buf, &txin);
 
+    // The fixed-record parser must agree with the reference one
+    if ((transaction_input_deserialize_record(data, size, &txin_record) == PARSING_OK) !=
+        (status == PARSING_OK)) {
+        __builtin_trap();
+    }
+
+    if (status == PARSING_OK &&
+        (txin_record.value != txin.value ||
+         memcmp(txin_record.tx_id, txin.tx_id, sizeof(txin.tx_id)) != 0 ||
+         txin_record.address_type != txin.address_type ||
+         txin_record.address_index != txin.address_index || txin_record.index != txin.index)) {
+        __builtin_trap();
+    }
+
     if (status == PARSING_OK) {
         format_u64(address_type, sizeof(address_type), txin.address_type);
         format_u64(address_index, sizeof(address_index), txin.address_index);
-        format_u64(sequence, sizeof(sequence), txin.sequence);
         format_u64(value, sizeof(value), txin.value);
         format_hex(txin.tx_id, sizeof(txin.tx_id), tx_id, sizeof(tx_id));
         format_u64(index, sizeof(index), txin.index);
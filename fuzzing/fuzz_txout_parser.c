@@ -36,16 +36,20 @@ int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
     transaction_output_t txout;
     parser_status_e status;
     char value[9] = {0};
-    char script_public_key[36] = {0};
+    char script_public_key[2 * SCRIPT_PUBLIC_KEY_BUFFER_LEN + 1] = {0};
+    script_arena_t scripts = {0};
 
     memset(&txout, 0, sizeof(txout));
 
-    status = transaction_output_deserialize(&buf, &txout);
+    status = transaction_output_deserialize(&buf, &txout, &scripts);
 
     if (status == PARSING_OK) {
         format_u64(value, sizeof(value), txout.value);
         // printf("value: %s\n", value);
-        format_hex(txout.script_public_key, 35, script_public_key, sizeof(script_public_key));
+        format_hex(scripts.data + txout.script_offset,
+                   txout.script_len,
+                   script_public_key,
+                   sizeof(script_public_key));
         // printf("script_public_key: %s\n", script_public_key);
     }
 
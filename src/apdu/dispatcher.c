@@ -34,6 +34,8 @@
 #include "../handler/get_version.h"
 #include "../handler/get_app_name.h"
 #include "../handler/get_public_key.h"
+#include "../handler/get_public_keys.h"
+#include "../handler/get_account_public_key.h"
 #include "../handler/sign_tx.h"
 #include "../handler/sign_msg.h"
 
@@ -75,11 +77,41 @@ int apdu_dispatcher(const command_t *cmd) {
             buf.offset = 0;
 
             return handler_get_public_key(&buf, (bool) cmd->p1);
+        case GET_PUBLIC_KEYS:
+            if (cmd->p1 != 0 || cmd->p2 != 0) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            if (!cmd->data) {
+                return io_send_sw(SW_WRONG_DATA_LENGTH);
+            }
+
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_get_public_keys(&buf);
+        case GET_ACCOUNT_PUBLIC_KEY:
+            if (cmd->p1 > 1 || cmd->p2 > 0) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
+
+            if (!cmd->data) {
+                return io_send_sw(SW_WRONG_DATA_LENGTH);
+            }
+
+            buf.ptr = cmd->data;
+            buf.size = cmd->lc;
+            buf.offset = 0;
+
+            return handler_get_account_public_key(&buf, (bool) cmd->p1);
         case SIGN_TX:
-            if ((cmd->p1 == P1_START && cmd->p2 != P2_MORE) ||    //
-                (cmd->p1 == P1_OUTPUTS && cmd->p2 != P2_MORE) ||  //
-                (cmd->p1 != P1_START && cmd->p1 != P1_OUTPUTS && cmd->p1 != P1_INPUTS &&
-                 cmd->p1 != P1_NEXT_SIGNATURE) ||
+            if ((cmd->p1 == P1_START && cmd->p2 != P2_MORE) ||            //
+                (cmd->p1 == P1_START_STREAMED && cmd->p2 != P2_MORE) ||   //
+                (cmd->p1 == P1_OUTPUTS && cmd->p2 != P2_MORE) ||          //
+                (cmd->p1 == P1_SIGN_INPUT && cmd->p2 != P2_LAST) ||       //
+                (cmd->p1 == P1_NEXT_SIGNATURES && cmd->p2 != P2_LAST) ||  //
+                cmd->p1 > P1_MAX ||                                       //
                 (cmd->p2 != P2_LAST && cmd->p2 != P2_MORE)) {
                 return io_send_sw(SW_WRONG_P1P2);
             }
@@ -94,11 +126,22 @@ int apdu_dispatcher(const command_t *cmd) {
 
             return handler_sign_tx(&buf, cmd->p1, (bool) (cmd->p2 & P2_MORE));
         case SIGN_MESSAGE:
+            if ((cmd->p1 == P1_MESSAGE_START_CHUNKED && cmd->p2 != P2_MORE) ||  //
+                (cmd->p1 == P1_MESSAGE_CHUNK && cmd->p2 != P2_LAST && cmd->p2 != P2_MORE)) {
+                return io_send_sw(SW_WRONG_P1P2);
+            }
 
             buf.ptr = cmd->data;
             buf.size = cmd->lc;
             buf.offset = 0;
 
+            if (cmd->p1 == P1_MESSAGE_START_CHUNKED) {
+                return handler_sign_msg_start_chunked(&buf);
+            }
+            if (cmd->p1 == P1_MESSAGE_CHUNK) {
+                return handler_sign_msg_chunk(&buf, (bool) (cmd->p2 & P2_MORE));
+            }
+
             return handler_sign_msg(&buf);
 #ifdef HAVE_DEBUG_APDU
         case DEBUG_APDU:
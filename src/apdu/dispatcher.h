@@ -44,10 +44,37 @@
 #define P1_INPUTS 0x02
 
 #define P1_NEXT_SIGNATURE 0x03
+/**
+ * Parameter 1 for the first APDU of a transaction whose inputs are
+ * streamed: they are answered with a commitment instead of being stored.
+ */
+#define P1_START_STREAMED 0x04
+/**
+ * Parameter 1 to re-send a streamed input with its commitment to sign it.
+ */
+#define P1_SIGN_INPUT 0x05
+/**
+ * Parameter 1 to ask for as many of the next signatures as fit in one response.
+ */
+#define P1_NEXT_SIGNATURES 0x06
 /**
  * Parameter 1 for maximum APDU number.
  */
-#define P1_MAX 0x03
+#define P1_MAX 0x06
+/**
+ * Flag of P1_NEXT_SIGNATURES to leave the sighashes out of the response.
+ */
+#define NEXT_SIGNATURES_NO_SIGHASH 0x01
+/**
+ * Parameter 1 of SIGN_MESSAGE to start a message sent in chunks, it
+ * carries the BIP32 path and the length of the message. Any other P1
+ * sends the whole message in one APDU.
+ */
+#define P1_MESSAGE_START_CHUNKED 0x10
+/**
+ * Parameter 1 of SIGN_MESSAGE for the next chunk of the message.
+ */
+#define P1_MESSAGE_CHUNK 0x11
 
 /**
  * Dispatch APDU command received to the right handler.
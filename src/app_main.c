@@ -34,9 +34,19 @@
 #include "ui/menu.h"
 #include "parser.h"
 #include "apdu/dispatcher.h"
+#include "precompute.h"
+#include "pubkey_cache.h"
 
 global_ctx_t G_context;
 
+/**
+ * Called by the SDK on every UI ticker event, including while a
+ * transaction is being reviewed.
+ */
+void app_ticker_event_callback(void) {
+    precompute_step();
+}
+
 /**
  * Handle APDU command received and send back APDU response using handlers.
  */
@@ -52,11 +62,13 @@ void app_main() {
 
     // Reset context
     explicit_bzero(&G_context, sizeof(G_context));
+    pubkey_cache_clear();
 
     for (;;) {
         // Receive command bytes in G_io_apdu_buffer
         if ((input_len = io_recv_command()) < 0) {
             PRINTF("=> io_recv_command failure\n");
+            pubkey_cache_clear();
             return;
         }
 
@@ -79,6 +91,7 @@ void app_main() {
         // Dispatch structured APDU command to handler
         if (apdu_dispatcher(&cmd) < 0) {
             PRINTF("=> apdu_dispatcher failure\n");
+            pubkey_cache_clear();
             return;
         }
     }
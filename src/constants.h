@@ -62,11 +62,40 @@
 
 /**
  * The signing key used for sighash
+ * The keyed hash states in hash.c are precomputed from these keys
  */
 #define SIGNING_KEY "TransactionSigningHash"
 
 #define MESSAGE_SIGNING_KEY "PersonalMessageSigningHash"
 
-#define MAX_OUTPUT_COUNT             2
-#define SCRIPT_PUBLIC_KEY_BUFFER_LEN 40
+/**
+ * Key of the commitments to streamed inputs, see input_commitment.h
+ */
+#define INPUT_COMMITMENT_KEY "InputCommitmentHash"
+
+/**
+ * Length of a serialized transaction input in the SIGN_TX APDU
+ */
+#define SERIALIZED_INPUT_LEN 46
+
+/**
+ * Maximum number of serialized inputs in one P1_INPUTS APDU
+ */
+#define MAX_INPUTS_PER_APDU (255 / SERIALIZED_INPUT_LEN)
+
+/**
+ * Length of the transaction header in the first SIGN_TX APDU
+ */
+#define TX_HEADER_LEN 13
+
+/**
+ * Flag of the optional last byte of the transaction header: every input
+ * is signed once the user approves and signatures are only copied out after
+ */
+#define TX_FLAG_SIGN_EAGERLY 0x01
+
+/**
+ * Longest output script: P2SH and ECDSA P2PK take 35 bytes, Schnorr P2PK 34
+ */
+#define SCRIPT_PUBLIC_KEY_BUFFER_LEN 35
 #define KASPA_MAX_BIP32_PATH_LEN     5
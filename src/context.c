@@ -0,0 +1,92 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stddef.h>  // size_t, offsetof
+#include <stdint.h>  // uint*_t
+#include <string.h>  // explicit_bzero
+
+#include "./context.h"
+#include "./globals.h"
+
+// Clears the transaction context but for the parts of the script arena and
+// of the input storage that were never written
+static void wipe_transaction(void) {
+    transaction_t *tx = &G_context.tx_info.transaction;
+
+    uint8_t *start = (uint8_t *) &G_context.tx_info;
+    uint8_t *end = start + sizeof(G_context.tx_info);
+    uint8_t *scripts = tx->tx_scripts.data;
+    uint8_t *inputs = (uint8_t *) tx->tx_inputs;
+    size_t inputs_area_len = sizeof(tx->tx_signatures) > sizeof(tx->tx_inputs)
+                                 ? sizeof(tx->tx_signatures)
+                                 : sizeof(tx->tx_inputs);
+
+    // Read before they are wiped
+    size_t scripts_used = tx->tx_scripts.high_water;
+    size_t inputs_used = G_context.tx_info.inputs_high_water;
+
+    if (scripts_used > sizeof(tx->tx_scripts.data)) {
+        scripts_used = sizeof(tx->tx_scripts.data);
+    }
+    if (inputs_used > inputs_area_len) {
+        inputs_used = inputs_area_len;
+    }
+
+    explicit_bzero(start, (size_t) (scripts - start) + scripts_used);
+
+    scripts += sizeof(tx->tx_scripts.data);
+    explicit_bzero(scripts, (size_t) (inputs - scripts) + inputs_used);
+
+    inputs += inputs_area_len;
+    explicit_bzero(inputs, (size_t) (end - inputs));
+}
+
+void context_reset(void) {
+    // Only the union is bounded, what surrounds it is small
+    switch (G_context.req_type) {
+        case CONFIRM_ADDRESS:
+            explicit_bzero(&G_context.pk_info, sizeof(G_context.pk_info));
+            break;
+        case CONFIRM_MESSAGE:
+            explicit_bzero(&G_context.msg_info, sizeof(G_context.msg_info));
+            break;
+        case CONFIRM_TRANSACTION:
+            wipe_transaction();
+            break;
+        default:
+            explicit_bzero(&G_context, sizeof(G_context));
+            return;
+    }
+
+    uint8_t *context = (uint8_t *) &G_context;
+
+    explicit_bzero(context, offsetof(global_ctx_t, tx_info));
+    explicit_bzero(context + offsetof(global_ctx_t, req_type),
+                   sizeof(G_context) - offsetof(global_ctx_t, req_type));
+}
+
+void context_mark_inputs(size_t len) {
+    if (len > G_context.tx_info.inputs_high_water) {
+        G_context.tx_info.inputs_high_water = (uint16_t) len;
+    }
+}
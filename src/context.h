@@ -0,0 +1,44 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#pragma once
+
+#include <stddef.h>  // size_t
+
+/**
+ * Wipe G_context before a new request. Only what the last request could
+ * have written is cleared, see context_mark_inputs, so that small
+ * requests such as GET_PUBLIC_KEY don't clear the whole transaction
+ * storage every time. Everything is zero afterwards.
+ */
+void context_reset(void);
+
+/**
+ * Record that the first len bytes of the input storage of the transaction,
+ * tx_inputs or tx_signatures, were written. Must be called before writing
+ * there, context_reset leaves the rest of that storage as is.
+ *
+ * @param[in] len
+ *   Bytes from the start of the input storage.
+ */
+void context_mark_inputs(size_t len);
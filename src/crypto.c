@@ -32,6 +32,7 @@
 
 #include "sighash.h"
 #include "personal_message.h"
+#include "context.h"
 
 bool crypto_validate_public_key(const uint32_t *bip32_path,
                                 uint8_t bip32_path_len,
@@ -55,13 +56,224 @@ bool crypto_validate_public_key(const uint32_t *bip32_path,
     return memcmp(raw_pubkey + 1, compressed_public_key, 32) == 0;
 }
 
-int crypto_sign_transaction(void) {
+// Order of the secp256k1 group
+static const uint8_t SECP256K1_N[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48,
+    0xA0, 0x3B, 0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x41};
+
+static int bip32_node_set_public_key(bip32_node_t *node) {
     cx_ecfp_private_key_t private_key = {0};
     cx_ecfp_public_key_t public_key = {0};
-    uint8_t chain_code[32] = {0};
 
-    transaction_input_t *txin =
-        &G_context.tx_info.transaction.tx_inputs[G_context.tx_info.signing_input_index];
+    int error = cx_ecfp_init_private_key_no_throw(CX_CURVE_256K1,
+                                                  node->private_key,
+                                                  sizeof(node->private_key),
+                                                  &private_key);
+    if (error == CX_OK) {
+        error = cx_ecfp_generate_pair_no_throw(CX_CURVE_256K1, &public_key, &private_key, 1);
+    }
+
+    if (error == CX_OK) {
+        // W is 0x04 || X || Y, compressed is 0x02 or 0x03 depending on Y's parity || X
+        node->public_key[0] = 0x02 | (public_key.W[64] & 0x01);
+        memmove(node->public_key + 1, public_key.W + 1, 32);
+    }
+
+    explicit_bzero(&private_key, sizeof(private_key));
+
+    return error;
+}
+
+static int bip32_account_node_init(uint32_t account, bip32_node_t *node) {
+    cx_ecfp_private_key_t private_key = {0};
+    // 44'/111111'/account'
+    const uint32_t path[3] = {0x8000002C, 0x8001b207, account};
+
+    int error = bip32_derive_init_privkey_256(CX_CURVE_256K1,
+                                              path,
+                                              sizeof(path) / sizeof(path[0]),
+                                              &private_key,
+                                              node->chain_code);
+    if (error == CX_OK) {
+        memmove(node->private_key, private_key.d, sizeof(node->private_key));
+        error = bip32_node_set_public_key(node);
+    }
+
+    explicit_bzero(&private_key, sizeof(private_key));
+
+    return error;
+}
+
+// CKDpriv from BIP32
+//
+// When parse256(IL) >= n or the child key is 0, BIP32 moves on to the next
+// index. This returns an error instead, as the caller asked for the key of
+// this index. It happens with a probability lower than 1 in 2^127.
+static int bip32_derive_child(const bip32_node_t *parent, uint32_t index, bip32_node_t *child) {
+    cx_hmac_sha512_t hmac;
+    uint8_t data[1 + 32 + 4] = {0};
+    uint8_t I[64] = {0};
+    uint8_t non_zero = 0;
+    int diff = 0;
+    int error = -1;
+
+    if (index & 0x80000000) {
+        // Hardened: 0x00 || ser256(k_par) || ser32(i)
+        memmove(data + 1, parent->private_key, 32);
+    } else {
+        // serP(K_par) || ser32(i)
+        memmove(data, parent->public_key, 33);
+    }
+    data[33] = (uint8_t) (index >> 24);
+    data[34] = (uint8_t) (index >> 16);
+    data[35] = (uint8_t) (index >> 8);
+    data[36] = (uint8_t) index;
+
+    // I = HMAC-SHA512(c_par, data)
+    error = cx_hmac_sha512_init_no_throw(&hmac, parent->chain_code, 32);
+    if (error == CX_OK) {
+        error = cx_hmac_no_throw((cx_hmac_t *) &hmac, CX_LAST, data, sizeof(data), I, sizeof(I));
+    }
+    if (error != CX_OK) {
+        goto end;
+    }
+    error = -1;
+
+    // parse256(IL) must be lower than n
+    if (cx_math_cmp_no_throw(I, SECP256K1_N, 32, &diff) != CX_OK || diff >= 0) {
+        goto end;
+    }
+
+    // k_i = parse256(IL) + k_par (mod n)
+    if (cx_math_addm_no_throw(child->private_key, I, parent->private_key, SECP256K1_N, 32) !=
+        CX_OK) {
+        goto end;
+    }
+
+    for (size_t i = 0; i < sizeof(child->private_key); i++) {
+        non_zero |= child->private_key[i];
+    }
+    if (non_zero == 0) {
+        goto end;
+    }
+
+    memmove(child->chain_code, I + 32, 32);
+
+    error = bip32_node_set_public_key(child);
+
+end:
+    explicit_bzero(&hmac, sizeof(hmac));
+    explicit_bzero(data, sizeof(data));
+    explicit_bzero(I, sizeof(I));
+
+    return error;
+}
+
+void crypto_wipe_derived_keys(void) {
+    // The counters are kept, see DEBUG_KEY_DERIVATION_STATS
+    PRINTF("Input keys derived: %d, reused: %d\n",
+           G_context.tx_info.key_derivations,
+           G_context.tx_info.key_derivations_saved);
+
+    explicit_bzero(&G_context.tx_info.account_node, sizeof(G_context.tx_info.account_node));
+    G_context.tx_info.account_node_ready = false;
+    explicit_bzero(&G_context.tx_info.address_node, sizeof(G_context.tx_info.address_node));
+    G_context.tx_info.address_node_ready = false;
+}
+
+int crypto_prepare_account_node(void) {
+    if (G_context.tx_info.account_node_ready) {
+        return CX_OK;
+    }
+
+    int error = bip32_account_node_init(G_context.tx_info.transaction.account,
+                                        &G_context.tx_info.account_node);
+    if (error != CX_OK) {
+        crypto_wipe_derived_keys();
+        return error;
+    }
+    G_context.tx_info.account_node_ready = true;
+
+    return CX_OK;
+}
+
+int crypto_prepare_address_node(const transaction_input_t *txin) {
+    bip32_node_t change_node = {0};
+
+    int error = crypto_prepare_account_node();
+    if (error != CX_OK) {
+        return error;
+    }
+
+    // Inputs sharing a path are signed one after the other, see group_inputs_by_path
+    if (G_context.tx_info.address_node_ready &&
+        G_context.tx_info.address_node_type == txin->address_type &&
+        G_context.tx_info.address_node_index == txin->address_index) {
+        G_context.tx_info.key_derivations_saved++;
+        return CX_OK;
+    }
+
+    explicit_bzero(&G_context.tx_info.address_node, sizeof(G_context.tx_info.address_node));
+    G_context.tx_info.address_node_ready = false;
+
+    error = bip32_derive_child(&G_context.tx_info.account_node,
+                               (uint32_t) txin->address_type,
+                               &change_node);
+    if (error == CX_OK) {
+        error = bip32_derive_child(&change_node,
+                                   txin->address_index,
+                                   &G_context.tx_info.address_node);
+    }
+    explicit_bzero(&change_node, sizeof(change_node));
+
+    if (error != CX_OK) {
+        explicit_bzero(&G_context.tx_info.address_node, sizeof(G_context.tx_info.address_node));
+        return error;
+    }
+
+    G_context.tx_info.address_node_type = txin->address_type;
+    G_context.tx_info.address_node_index = txin->address_index;
+    G_context.tx_info.address_node_ready = true;
+    G_context.tx_info.key_derivations++;
+
+    return CX_OK;
+}
+
+int crypto_derive_public_keys(uint32_t account,
+                              uint8_t address_type,
+                              uint32_t first_index,
+                              uint8_t count,
+                              uint8_t (*public_keys)[32]) {
+    bip32_node_t account_node = {0};
+    bip32_node_t change_node = {0};
+    bip32_node_t address_node = {0};
+
+    // The hardened levels and address_type are derived once for the whole range
+    int error = bip32_account_node_init(account, &account_node);
+    if (error == CX_OK) {
+        error = bip32_derive_child(&account_node, (uint32_t) address_type, &change_node);
+    }
+    explicit_bzero(&account_node, sizeof(account_node));
+
+    for (uint8_t i = 0; error == CX_OK && i < count; i++) {
+        error = bip32_derive_child(&change_node, first_index + i, &address_node);
+        if (error == CX_OK) {
+            // x-coordinate only, the compressed public key without its prefix
+            memmove(public_keys[i], address_node.public_key + 1, 32);
+        }
+    }
+
+    explicit_bzero(&change_node, sizeof(change_node));
+    explicit_bzero(&address_node, sizeof(address_node));
+
+    return error;
+}
+
+int crypto_sign_transaction(transaction_input_t *txin) {
+    cx_ecfp_private_key_t private_key = {0};
+    const bip32_node_t *address_node = &G_context.tx_info.address_node;
+    int error = 0;
 
     // 44'/111111'/account'/ address_type / address_index
     G_context.bip32_path[0] = 0x8000002C;
@@ -72,12 +284,18 @@ int crypto_sign_transaction(void) {
 
     G_context.bip32_path_len = 5;
 
-    int error = bip32_derive_init_privkey_256(CX_CURVE_256K1,
-                                              G_context.bip32_path,
-                                              G_context.bip32_path_len,
-                                              &private_key,
-                                              chain_code);
+    // The hardened levels are the same for every input of the transaction,
+    // they are only derived once
+    error = crypto_prepare_address_node(txin);
+    if (error == CX_OK) {
+        error = cx_ecfp_init_private_key_no_throw(CX_CURVE_256K1,
+                                                  address_node->private_key,
+                                                  sizeof(address_node->private_key),
+                                                  &private_key);
+    }
+
     if (error != CX_OK) {
+        explicit_bzero(&private_key, sizeof(private_key));
         return error;
     }
 
@@ -87,14 +305,9 @@ int crypto_sign_transaction(void) {
             memset(G_context.tx_info.sighash, 0, sizeof(G_context.tx_info.sighash));
             memset(G_context.tx_info.signature, 0, sizeof(G_context.tx_info.signature));
 
-            error = cx_ecfp_generate_pair_no_throw(CX_CURVE_256K1, &public_key, &private_key, 1);
-            if (error != CX_OK) {
-                return error;
-            }
-
-            if (!calc_sighash(&G_context.tx_info.transaction,
+            if (!calc_sighash(&G_context.tx_info.sighash_cache,
                               txin,
-                              public_key.W + 1,
+                              address_node->public_key + 1,
                               G_context.tx_info.sighash,
                               sizeof(G_context.tx_info.sighash))) {
                 return -1;
@@ -113,7 +326,6 @@ int crypto_sign_transaction(void) {
             }
         }
         FINALLY {
-            explicit_bzero(&public_key, sizeof(public_key));
             explicit_bzero(&private_key, sizeof(private_key));
         }
     }
@@ -122,8 +334,72 @@ int crypto_sign_transaction(void) {
     return error;
 }
 
+// Rearrange the inputs so that tx_inputs[p] is the input signed at position p
+static void sort_inputs_in_signing_order(transaction_t *tx, const uint8_t *order) {
+    uint8_t moved[(MAX_INPUT_COUNT + 7) / 8] = {0};
+    transaction_input_t first;
+
+    // Follow each cycle of the permutation, one input is kept aside
+    for (size_t start = 0; start < tx->tx_input_len; start++) {
+        if (moved[start / 8] & (1 << (start % 8))) {
+            continue;
+        }
+
+        first = tx->tx_inputs[start];
+        size_t p = start;
+        while (order[p] != start) {
+            tx->tx_inputs[p] = tx->tx_inputs[order[p]];
+            moved[p / 8] |= 1 << (p % 8);
+            p = order[p];
+        }
+        tx->tx_inputs[p] = first;
+        moved[p / 8] |= 1 << (p % 8);
+    }
+}
+
+int crypto_sign_transaction_all(void) {
+    transaction_t *tx = &G_context.tx_info.transaction;
+    int error = 0;
+
+    sort_inputs_in_signing_order(tx, G_context.tx_info.signing_order);
+
+    // Move the inputs to the end of the area they share with the signatures.
+    // Inputs are smaller than signatures and the area holds at least
+    // tx_input_len signatures (see MAX_EAGER_SIGNATURE_COUNT), so the input at
+    // position p + 1 never starts before (p + 1) * MAX_DER_SIG_LEN, where the
+    // signature at position p ends: no input is overwritten before it is signed.
+    uint8_t *area = (uint8_t *) tx->tx_signatures;
+    size_t area_len = sizeof(tx->tx_signatures) > sizeof(tx->tx_inputs)
+                          ? sizeof(tx->tx_signatures)
+                          : sizeof(tx->tx_inputs);
+    size_t inputs_len = tx->tx_input_len * sizeof(transaction_input_t);
+    transaction_input_t *inputs = (transaction_input_t *) (area + area_len - inputs_len);
+
+    // Writes at both ends of the area, it is wiped whole afterwards
+    context_mark_inputs(area_len);
+
+    memmove(inputs, tx->tx_inputs, inputs_len);
+
+    for (size_t p = 0; p < tx->tx_input_len; p++) {
+        G_context.tx_info.signing_input_index = G_context.tx_info.signing_order[p];
+
+        error = crypto_sign_transaction(&inputs[p]);
+        if (error != 0) {
+            break;
+        }
+
+        memmove(tx->tx_signatures[p], G_context.tx_info.signature, MAX_DER_SIG_LEN);
+    }
+
+    crypto_wipe_derived_keys();
+
+    return error;
+}
+
 int crypto_sign_personal_message(void) {
-    if (!hash_personal_message(G_context.msg_info.message,
+    // Chunked messages were hashed as they arrived
+    if (!G_context.msg_info.chunked &&
+        !hash_personal_message(G_context.msg_info.message,
                                G_context.msg_info.message_len,
                                G_context.msg_info.message_hash,
                                sizeof(G_context.msg_info.message_hash))) {
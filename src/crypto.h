@@ -28,16 +28,97 @@
 
 #include "cx.h"
 
+#include "transaction/types.h"
+
 /**
- * Sign message hash in global context.
+ * Sign the sighash of a transaction input in global context.
+ *
+ * The hardened part of the path (44'/111111'/account') is derived on the
+ * first call and kept in G_context.tx_info.account_node, later calls only
+ * derive the two non-hardened levels of the input. The key of the last
+ * input is kept in G_context.tx_info.address_node and reused as is by the
+ * next input if it has the same path.
  *
  * @see G_context.bip32_path,
  * G_context.tx_info.signature.
  *
+ * @param[in] txin
+ *   The input to sign, stored or streamed
+ *
+ * @return 0 on success, error number otherwise.
+ *
+ */
+int crypto_sign_transaction(transaction_input_t *txin);
+
+/**
+ * Derive 44'/111111'/account' into G_context.tx_info.account_node, unless
+ * it already holds it.
+ *
+ * @return 0 on success, error number otherwise.
+ *
+ */
+int crypto_prepare_account_node(void);
+
+/**
+ * Derive the key of an input into G_context.tx_info.address_node, unless
+ * it already holds it. The account node is derived first if needed.
+ *
+ * @param[in] txin
+ *   The input whose key is derived
+ *
+ * @return 0 on success, error number otherwise.
+ *
+ */
+int crypto_prepare_address_node(const transaction_input_t *txin);
+
+/**
+ * Derive the public keys of consecutive addresses of an account,
+ * 44'/111111'/account'/address_type/index for index in
+ * [first_index, first_index + count).
+ *
+ * The hardened part of the path and address_type are derived once, each
+ * key then only costs the derivation of its last level.
+ *
+ * @param[in]  account
+ *   Account of the addresses, hardened or not as given.
+ * @param[in]  address_type
+ *   0 for receive addresses, 1 for change addresses.
+ * @param[in]  first_index
+ *   Index of the first address.
+ * @param[in]  count
+ *   Number of addresses.
+ * @param[out] public_keys
+ *   The x-coordinates of the public keys, count of them.
+ *
+ * @return 0 on success, error number otherwise.
+ *
+ */
+int crypto_derive_public_keys(uint32_t account,
+                              uint8_t address_type,
+                              uint32_t first_index,
+                              uint8_t count,
+                              uint8_t (*public_keys)[32]);
+
+/**
+ * Sign every input of the transaction in G_context.tx_info.signing_order.
+ * Signature p is written to G_context.tx_info.transaction.tx_signatures[p],
+ * which overlays the inputs so they can't be used anymore afterwards.
+ *
+ * @see TX_FLAG_SIGN_EAGERLY.
+ *
  * @return 0 on success, error number otherwise.
  *
  */
-int crypto_sign_transaction(void);
+int crypto_sign_transaction_all(void);
+
+/**
+ * Securely wipe the keys cached by crypto_sign_transaction.
+ * Called once the transaction is fully signed or aborted.
+ *
+ * @see G_context.tx_info.account_node, G_context.tx_info.address_node.
+ *
+ */
+void crypto_wipe_derived_keys(void);
 
 /**
  * Checks if the compressed public key matches the
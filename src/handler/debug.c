@@ -26,12 +26,18 @@
 
 #include "cx.h"
 #include "io.h"
+#include "write.h"
 
 #include "../sw.h"
 #include "../types.h"
+#include "../globals.h"
+#include "../pubkey_cache.h"
+#include "debug.h"
 
 #ifdef HAVE_DEBUG_APDU
 
+bool G_debug_fail_next_output_format = false;
+
 static int helper_send_response_sig(uint8_t* signature) {
     uint8_t resp[66] = {0};
     size_t offset = 0;
@@ -183,9 +189,44 @@ static void debug_test_case_4(uint8_t* signature) {
         &info);
 }
 
+// hits (4) || misses (4), big endian
+static int helper_send_response_pubkey_cache_stats(void) {
+    uint8_t resp[8] = {0};
+
+    write_u32_be(resp, 0, pubkey_cache_hits());
+    write_u32_be(resp, 4, pubkey_cache_misses());
+
+    return io_send_response_pointer(resp, sizeof(resp), SW_OK);
+}
+
+// derived (2) || reused (2), big endian, zero if no transaction was started
+static int helper_send_response_key_derivation_stats(void) {
+    uint8_t resp[4] = {0};
+
+    if (G_context.req_type == CONFIRM_TRANSACTION) {
+        write_u16_be(resp, 0, G_context.tx_info.key_derivations);
+        write_u16_be(resp, 2, G_context.tx_info.key_derivations_saved);
+    }
+
+    return io_send_response_pointer(resp, sizeof(resp), SW_OK);
+}
+
 int handler_debug(int test_case) {
     uint8_t signature[72] = {0};
 
+    if (test_case == DEBUG_PUBKEY_CACHE_STATS) {
+        return helper_send_response_pubkey_cache_stats();
+    }
+
+    if (test_case == DEBUG_KEY_DERIVATION_STATS) {
+        return helper_send_response_key_derivation_stats();
+    }
+
+    if (test_case == DEBUG_FAIL_NEXT_OUTPUT_FORMAT) {
+        G_debug_fail_next_output_format = true;
+        return io_send_sw(SW_OK);
+    }
+
     switch (test_case) {
         case 1:
             debug_test_case_1(signature);
@@ -21,6 +21,34 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  *****************************************************************************/
+#pragma once
+
+#include <stdbool.h>  // bool
+
 #ifdef HAVE_DEBUG_APDU
+/**
+ * P1 of the debug APDU asking for the hit and miss counters of the
+ * public key cache, see pubkey_cache.h.
+ */
+#define DEBUG_PUBKEY_CACHE_STATS 0x10
+
+/**
+ * P1 of the debug APDU asking for the input keys derived and reused by
+ * the transaction in G_context, see crypto_prepare_address_node.
+ */
+#define DEBUG_KEY_DERIVATION_STATS 0x11
+
+/**
+ * P1 of the debug APDU making the next output formatted for review fail,
+ * so that tests can go through the abort_transaction path of the review.
+ */
+#define DEBUG_FAIL_NEXT_OUTPUT_FORMAT 0x12
+
+/**
+ * Set by DEBUG_FAIL_NEXT_OUTPUT_FORMAT, cleared by the output format it
+ * makes fail. Kept out of G_context, which every transaction resets.
+ */
+extern bool G_debug_fail_next_output_format;
+
 int handler_debug(int test_case);
 #endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <string.h>   // memmove
+
+#include "os.h"
+#include "crypto_helpers.h"
+
+#include "get_account_public_key.h"
+#include "../globals.h"
+#include "../types.h"
+#include "io.h"
+#include "../sw.h"
+#include "../pubkey_cache.h"
+#include "../context.h"
+#include "buffer.h"
+#include "../ui/display.h"
+#include "../helper/send_response.h"
+
+int handler_get_account_public_key(buffer_t *cdata, bool display) {
+    context_reset();
+    G_context.req_type = CONFIRM_ADDRESS;
+    G_context.state = STATE_NONE;
+
+    uint8_t raw_pubkey[65] = {0};
+    uint32_t account = 0;
+
+    if (!buffer_read_u32(cdata, &account, BE) || cdata->offset != cdata->size) {
+        return io_send_sw(SW_WRONG_DATA_LENGTH);
+    }
+
+    // Account must be hardened, the addresses below it are derived on the host
+    if (account < 0x80000000) {
+        return io_send_sw(SW_WRONG_BIP32_ACCOUNT);
+    }
+
+    // 44'/111111'/account'
+    G_context.bip32_path[0] = 0x8000002C;
+    G_context.bip32_path[1] = 0x8001b207;
+    G_context.bip32_path[2] = account;
+
+    G_context.bip32_path_len = 3;
+
+    // Wallets keep asking for the same few paths, only derive them once
+    if (!pubkey_cache_get(G_context.bip32_path, G_context.bip32_path_len, &G_context.pk_info)) {
+        int error = bip32_derive_get_pubkey_256(CX_CURVE_256K1,
+                                                G_context.bip32_path,
+                                                G_context.bip32_path_len,
+                                                raw_pubkey,
+                                                G_context.pk_info.chain_code,
+                                                CX_SHA512);
+
+        if (error != CX_OK) {
+            return io_send_sw(error);
+        }
+
+        memmove(G_context.pk_info.raw_public_key, raw_pubkey + 1, 64);
+
+        pubkey_cache_put(G_context.bip32_path, G_context.bip32_path_len, &G_context.pk_info);
+    }
+
+    if (display) {
+        return ui_display_account_public_key();
+    }
+
+    return helper_send_response_pubkey();
+}
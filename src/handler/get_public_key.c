@@ -24,7 +24,7 @@
 #include <stdint.h>   // uint*_t
 #include <stdbool.h>  // bool
 #include <stddef.h>   // size_t
-#include <string.h>   // memset, explicit_bzero
+#include <string.h>   // memmove
 
 #include "os.h"
 #include "crypto_helpers.h"
@@ -35,12 +35,14 @@
 #include "io.h"
 #include "../sw.h"
 #include "../crypto.h"
+#include "../pubkey_cache.h"
+#include "../context.h"
 #include "buffer.h"
 #include "../ui/display.h"
 #include "../helper/send_response.h"
 
 int handler_get_public_key(buffer_t *cdata, bool display) {
-    explicit_bzero(&G_context, sizeof(G_context));
+    context_reset();
     G_context.req_type = CONFIRM_ADDRESS;
     G_context.state = STATE_NONE;
 
@@ -63,18 +65,23 @@ int handler_get_public_key(buffer_t *cdata, bool display) {
         return io_send_sw(SW_WRONG_BIP32_COIN_TYPE);
     }
 
-    int error = bip32_derive_get_pubkey_256(CX_CURVE_256K1,
-                                            G_context.bip32_path,
-                                            G_context.bip32_path_len,
-                                            raw_pubkey,
-                                            G_context.pk_info.chain_code,
-                                            CX_SHA512);
+    // Wallets keep asking for the same few paths, only derive them once
+    if (!pubkey_cache_get(G_context.bip32_path, G_context.bip32_path_len, &G_context.pk_info)) {
+        int error = bip32_derive_get_pubkey_256(CX_CURVE_256K1,
+                                                G_context.bip32_path,
+                                                G_context.bip32_path_len,
+                                                raw_pubkey,
+                                                G_context.pk_info.chain_code,
+                                                CX_SHA512);
 
-    if (error != CX_OK) {
-        return io_send_sw(error);
-    }
+        if (error != CX_OK) {
+            return io_send_sw(error);
+        }
+
+        memmove(G_context.pk_info.raw_public_key, raw_pubkey + 1, 64);
 
-    memmove(G_context.pk_info.raw_public_key, raw_pubkey + 1, 64);
+        pubkey_cache_put(G_context.bip32_path, G_context.bip32_path_len, &G_context.pk_info);
+    }
 
     if (display) {
         return ui_display_address();
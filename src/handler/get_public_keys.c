@@ -0,0 +1,83 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+
+#include "os.h"
+
+#include "get_public_keys.h"
+#include "../globals.h"
+#include "../types.h"
+#include "io.h"
+#include "../sw.h"
+#include "../crypto.h"
+#include "../context.h"
+#include "buffer.h"
+#include "../helper/send_response.h"
+
+int handler_get_public_keys(buffer_t *cdata) {
+    context_reset();
+    G_context.req_type = CONFIRM_ADDRESS;
+    G_context.state = STATE_NONE;
+
+    uint32_t account = 0;
+    uint8_t address_type = 0;
+    uint32_t first_index = 0;
+    uint8_t count = 0;
+    uint8_t public_keys[PUBKEYS_MAX_COUNT][32] = {0};
+
+    if (!buffer_read_u32(cdata, &account, BE) ||      //
+        !buffer_read_u8(cdata, &address_type) ||      //
+        !buffer_read_u32(cdata, &first_index, BE) ||  //
+        !buffer_read_u8(cdata, &count) ||             //
+        count == 0 || cdata->offset != cdata->size) {
+        return io_send_sw(SW_WRONG_DATA_LENGTH);
+    }
+
+    // Same accounts and address types as the inputs of a transaction
+    if (account < 0x80000000) {
+        return io_send_sw(SW_WRONG_BIP32_ACCOUNT);
+    }
+
+    if (address_type != RECEIVE && address_type != CHANGE) {
+        return io_send_sw(SW_WRONG_BIP32_ADDRESS_TYPE);
+    }
+
+    // Only send what fits, the host asks again for the rest of the range
+    if (count > PUBKEYS_MAX_COUNT) {
+        count = PUBKEYS_MAX_COUNT;
+    }
+    // and stop at the last index
+    if (count - 1 > UINT32_MAX - first_index) {
+        count = (uint8_t) (UINT32_MAX - first_index + 1);
+    }
+
+    int error = crypto_derive_public_keys(account, address_type, first_index, count, public_keys);
+
+    if (error != CX_OK) {
+        return io_send_sw(error);
+    }
+
+    return helper_send_response_pubkeys(public_keys, count);
+}
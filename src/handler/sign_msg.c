@@ -21,17 +21,53 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  * SOFTWARE.
  *****************************************************************************/
-#include <stdint.h>  // uint*_t
-#include <string.h>  // memset, explicit_bzero
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <string.h>   // memcpy
 
 #include "types.h"
 #include "buffer.h"
 #include "./globals.h"
 #include "./sign_msg.h"
 #include "../sw.h"
+#include "../personal_message.h"
+#include "../context.h"
 #include "../ui/display.h"
 #include "../helper/send_response.h"
 
+// address_type (1) || address_index (4) || account (4), the key signing the message
+static bool read_message_signer(buffer_t *cdata) {
+    if (!buffer_read_u8(cdata, &G_context.msg_info.address_type)) {
+        return false;
+    }
+
+    if (G_context.msg_info.address_type != 0 && G_context.msg_info.address_type != 1) {
+        return false;
+    }
+
+    if (!buffer_read_u32(cdata, &G_context.msg_info.address_index, BE)) {
+        return false;
+    }
+
+    if (!buffer_read_u32(cdata, &G_context.msg_info.account, BE)) {
+        return false;
+    }
+
+    if (G_context.msg_info.account < 0x80000000) {
+        return false;
+    }
+
+    G_context.bip32_path[0] = 0x8000002C;
+    G_context.bip32_path[1] = 0x8001b207;
+    G_context.bip32_path[2] = G_context.msg_info.account;
+    G_context.bip32_path[3] = (uint32_t)(G_context.msg_info.address_type);
+    G_context.bip32_path[4] = G_context.msg_info.address_index;
+
+    G_context.bip32_path_len = 5;
+
+    return true;
+}
+
 /**
  * Handler for SIGN_MESSAGE command. If successfully parse BIP32 path
  * and message, sign the message and send APDU response.
@@ -45,27 +81,11 @@
  *
  */
 int handler_sign_msg(buffer_t *cdata) {
-    explicit_bzero(&G_context, sizeof(G_context));
+    context_reset();
     G_context.req_type = CONFIRM_MESSAGE;
     G_context.state = STATE_NONE;
 
-    if (!buffer_read_u8(cdata, &G_context.msg_info.address_type)) {
-        return io_send_sw(SW_MESSAGE_ADDRESS_TYPE_FAIL);
-    }
-
-    if (G_context.msg_info.address_type != 0 && G_context.msg_info.address_type != 1) {
-        return io_send_sw(SW_MESSAGE_ADDRESS_TYPE_FAIL);
-    }
-
-    if (!buffer_read_u32(cdata, &G_context.msg_info.address_index, BE)) {
-        return io_send_sw(SW_MESSAGE_ADDRESS_TYPE_FAIL);
-    }
-
-    if (!buffer_read_u32(cdata, &G_context.msg_info.account, BE)) {
-        return io_send_sw(SW_MESSAGE_ADDRESS_TYPE_FAIL);
-    }
-
-    if (G_context.msg_info.account < 0x80000000) {
+    if (!read_message_signer(cdata)) {
         return io_send_sw(SW_MESSAGE_ADDRESS_TYPE_FAIL);
     }
 
@@ -94,13 +114,91 @@ int handler_sign_msg(buffer_t *cdata) {
         return io_send_sw(SW_MESSAGE_UNEXPECTED);
     }
 
-    G_context.bip32_path[0] = 0x8000002C;
-    G_context.bip32_path[1] = 0x8001b207;
-    G_context.bip32_path[2] = G_context.msg_info.account;
-    G_context.bip32_path[3] = (uint32_t)(G_context.msg_info.address_type);
-    G_context.bip32_path[4] = G_context.msg_info.address_index;
+    return ui_display_message();
+}
 
-    G_context.bip32_path_len = 5;
+int handler_sign_msg_start_chunked(buffer_t *cdata) {
+    context_reset();
+    G_context.req_type = CONFIRM_MESSAGE;
+    G_context.state = STATE_NONE;
+
+    if (!read_message_signer(cdata)) {
+        return io_send_sw(SW_MESSAGE_ADDRESS_TYPE_FAIL);
+    }
+
+    if (!buffer_read_u16(cdata, &G_context.msg_info.message_total_len, BE) ||
+        cdata->offset != cdata->size) {
+        return io_send_sw(SW_MESSAGE_LEN_PARSING_FAIL);
+    }
+
+    if (G_context.msg_info.message_total_len == 0) {
+        return io_send_sw(SW_MESSAGE_TOO_SHORT);
+    }
+
+    if (!personal_message_hash_init(&G_context.msg_info.message_hash_writer)) {
+        return io_send_sw(SW_MESSAGE_UNEXPECTED);
+    }
+
+    G_context.msg_info.chunked = true;
+
+    return io_send_sw(SW_OK);
+}
+
+int handler_sign_msg_chunk(buffer_t *cdata, bool more) {
+    message_sign_ctx_t *msg_info = &G_context.msg_info;
+
+    // Nothing is accepted once the whole message was received and is reviewed
+    if (G_context.req_type != CONFIRM_MESSAGE || G_context.state != STATE_NONE ||
+        !msg_info->chunked || msg_info->message_received == msg_info->message_total_len) {
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    size_t chunk_len = cdata->size - cdata->offset;
+    const uint8_t *chunk = cdata->ptr + cdata->offset;
+    size_t remaining = msg_info->message_total_len - msg_info->message_received;
+
+    if (chunk_len == 0) {
+        return io_send_sw(SW_MESSAGE_PARSING_FAIL);
+    }
+
+    if (chunk_len > remaining) {
+        return io_send_sw(SW_MESSAGE_TOO_LONG);
+    }
+
+    if (!more && chunk_len < remaining) {
+        return io_send_sw(SW_MESSAGE_TOO_SHORT);
+    }
+
+    // The chunk that completes the message has to be sent as the last one
+    if (more && chunk_len == remaining) {
+        return io_send_sw(SW_WRONG_P1P2);
+    }
+
+    // Only the start of the message is kept, to be displayed
+    if (msg_info->message_len < sizeof(msg_info->message)) {
+        size_t preview_len = sizeof(msg_info->message) - msg_info->message_len;
+        if (preview_len > chunk_len) {
+            preview_len = chunk_len;
+        }
+        memcpy(msg_info->message + msg_info->message_len, chunk, preview_len);
+        msg_info->message_len += preview_len;
+    }
+
+    if (!personal_message_hash_update(&msg_info->message_hash_writer, chunk, chunk_len)) {
+        return io_send_sw(SW_MESSAGE_UNEXPECTED);
+    }
+    msg_info->message_received += (uint16_t) chunk_len;
+
+    if (more) {
+        return io_send_sw(SW_OK);
+    }
+
+    // The hash is displayed as the message may not fit on screen
+    if (!personal_message_hash_finalize(&msg_info->message_hash_writer,
+                                        msg_info->message_hash,
+                                        sizeof(msg_info->message_hash))) {
+        return io_send_sw(SW_MESSAGE_UNEXPECTED);
+    }
 
     return ui_display_message();
-}
\ No newline at end of file
+}
@@ -23,7 +23,8 @@
  *****************************************************************************/
 #pragma once
 
-#include <stdint.h>  // uint*_t
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
 
 #include "buffer.h"
 
@@ -40,3 +41,36 @@
  *
  */
 int handler_sign_msg(buffer_t *cdata);
+
+/**
+ * Handler for the first APDU of a SIGN_MESSAGE command whose message is
+ * sent in chunks, see P1_MESSAGE_START_CHUNKED. Parse the BIP32 path and
+ * the length of the whole message and start its hash.
+ *
+ * @see G_context.msg_info.
+ *
+ * @param[in,out] cdata
+ *   Command data with BIP32 path and message length.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_sign_msg_start_chunked(buffer_t *cdata);
+
+/**
+ * Handler for a chunk of a message sent in chunks, see P1_MESSAGE_CHUNK.
+ * The chunk is hashed and only the start of the message is kept for the
+ * review, so the length of the message doesn't change the memory used.
+ * Once the last chunk is received, the message is displayed.
+ *
+ * @see G_context.msg_info.
+ *
+ * @param[in,out] cdata
+ *   Command data with the chunk.
+ * @param[in]     more
+ *   Whether more chunks follow or not, the last chunk must complete the message.
+ *
+ * @return zero or positive integer if success, negative integer otherwise.
+ *
+ */
+int handler_sign_msg_chunk(buffer_t *cdata, bool more);
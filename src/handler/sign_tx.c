@@ -24,7 +24,6 @@
 #include <stdint.h>   // uint*_t
 #include <stdbool.h>  // bool
 #include <stddef.h>   // size_t
-#include <string.h>   // memset, explicit_bzero
 
 #include "os.h"
 #include "cx.h"
@@ -40,41 +39,269 @@
 #include "../transaction/types.h"
 #include "../transaction/deserialize.h"
 #include "../transaction/tx_validate.h"
+#include "../transaction/utils.h"
+#include "../sighash.h"
+#include "../context.h"
+#include "../precompute.h"
+#include "../input_commitment.h"
 #include "../helper/send_response.h"
 
 static int sign_input_and_send() {
-    int error = crypto_sign_transaction();
+    if (G_context.tx_info.signing_position >= G_context.tx_info.transaction.tx_input_len) {
+        // Every input was already signed
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    G_context.tx_info.signing_input_index =
+        G_context.tx_info.signing_order[G_context.tx_info.signing_position];
+
+    int error = crypto_sign_transaction(
+        &G_context.tx_info.transaction.tx_inputs[G_context.tx_info.signing_input_index]);
     if (error != 0) {
         G_context.state = STATE_NONE;
+        crypto_wipe_derived_keys();
         io_send_sw(error);
     } else {
         helper_send_response_sig();
-        G_context.tx_info.signing_input_index++;
+        G_context.tx_info.signing_position++;
+        if (G_context.tx_info.signing_position >= G_context.tx_info.transaction.tx_input_len) {
+            crypto_wipe_derived_keys();
+        }
     }
 
     return error;
 }
 
-int handler_sign_tx(buffer_t *cdata, uint8_t type, bool more) {
-    if (type == 0) {
-        explicit_bzero(&G_context, sizeof(G_context));
-        G_context.req_type = CONFIRM_TRANSACTION;
+static int sign_inputs_and_send(bool with_sighash) {
+    // has_more (1) || count (1) || records, built where it is sent from
+    // instead of on the stack. The flags byte of the command was already read.
+    uint8_t *resp = G_io_apdu_buffer;
+    size_t offset = 2;
+    uint8_t count = 0;
+
+    if (G_context.tx_info.signing_position >= G_context.tx_info.transaction.tx_input_len) {
+        // Every input was already signed
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    while (G_context.tx_info.signing_position < G_context.tx_info.transaction.tx_input_len &&
+           offset + SIG_RECORD_LEN(with_sighash) <= IO_APDU_BUFFER_SIZE - 2) {
+        G_context.tx_info.signing_input_index =
+            G_context.tx_info.signing_order[G_context.tx_info.signing_position];
+
+        int error = crypto_sign_transaction(
+            &G_context.tx_info.transaction.tx_inputs[G_context.tx_info.signing_input_index]);
+        if (error != 0) {
+            G_context.state = STATE_NONE;
+            crypto_wipe_derived_keys();
+            return io_send_sw(error);
+        }
+
+        offset += helper_write_sig_record(resp + offset,
+                                          G_context.tx_info.signing_input_index,
+                                          G_context.tx_info.signature,
+                                          with_sighash ? G_context.tx_info.sighash : NULL);
+        G_context.tx_info.signing_position++;
+        count++;
+    }
+
+    resp[0] = G_context.tx_info.transaction.tx_input_len - G_context.tx_info.signing_position;
+    resp[1] = count;
+
+    if (G_context.tx_info.signing_position >= G_context.tx_info.transaction.tx_input_len) {
+        crypto_wipe_derived_keys();
+    }
+
+    return io_send_response_pointer(resp, offset, SW_OK);
+}
+
+static int start_transaction(buffer_t *cdata, bool streamed) {
+    context_reset();
+    G_context.req_type = CONFIRM_TRANSACTION;
+    G_context.state = STATE_NONE;
+    G_context.tx_info.streamed = streamed;
+
+    // The header may end with a flags byte
+    if (!streamed && cdata->size == TX_HEADER_LEN + 1) {
+        G_context.tx_info.sign_eagerly = (cdata->ptr[TX_HEADER_LEN] & TX_FLAG_SIGN_EAGERLY) != 0;
+        cdata->size = TX_HEADER_LEN;
+    }
+
+    parser_status_e status =
+        streamed ? transaction_deserialize_streamed(cdata,
+                                                    &G_context.tx_info.transaction,
+                                                    G_context.bip32_path)
+                 : transaction_deserialize(cdata,
+                                           &G_context.tx_info.transaction,
+                                           G_context.bip32_path);
+
+    PRINTF("Header Parsing status: %d.\n", status);
+
+    if (status != PARSING_OK) {
+        return io_send_sw(SW_TX_PARSING_FAIL);
+    }
+
+    // The signatures are kept where the inputs were, which is too small for
+    // as many signatures as inputs
+    if (G_context.tx_info.sign_eagerly &&
+        G_context.tx_info.transaction.tx_input_len > MAX_EAGER_SIGNATURE_COUNT) {
+        return io_send_sw(SW_TX_PARSING_FAIL);
+    }
+
+    if (streamed) {
+        // A new key for every transaction, commitments from another one won't verify
+        cx_rng_no_throw(G_context.tx_info.session_key, sizeof(G_context.tx_info.session_key));
+    }
+
+    // Inputs are hashed as they arrive, the outputs once they are all stored
+    if (!sighash_cache_start(&G_context.tx_info.sighash_cache)) {
+        return io_send_sw(SW_TX_HASH_FAIL);
+    }
+
+    return io_send_sw(SW_OK);
+}
+
+static int sign_streamed_input(buffer_t *cdata) {
+    transaction_input_t txin = {0};
+    uint16_t input_index = 0;
+
+    // Serialized input || input index (2) || commitment
+    if (cdata->size != SERIALIZED_INPUT_LEN + 2 + INPUT_COMMITMENT_LEN) {
+        return io_send_sw(SW_WRONG_DATA_LENGTH);
+    }
+
+    if (transaction_input_deserialize_record(cdata->ptr, SERIALIZED_INPUT_LEN, &txin) !=
+        PARSING_OK) {
+        return io_send_sw(SW_TX_PARSING_FAIL);
+    }
+
+    if (!buffer_seek_cur(cdata, SERIALIZED_INPUT_LEN) ||
+        !buffer_read_u16(cdata, &input_index, BE)) {
+        return io_send_sw(SW_TX_PARSING_FAIL);
+    }
+
+    if (input_index >= G_context.tx_info.transaction.tx_input_len) {
+        return io_send_sw(SW_TX_PARSING_FAIL);
+    }
+
+    // Only sign an input exactly as it was streamed and reviewed
+    if (!check_input_commitment(G_context.tx_info.session_key,
+                                input_index,
+                                cdata->ptr,
+                                SERIALIZED_INPUT_LEN,
+                                cdata->ptr + cdata->offset)) {
+        return io_send_sw(SW_INPUT_COMMITMENT_FAIL);
+    }
+
+    // Each input is signed once
+    uint8_t *signed_inputs = G_context.tx_info.transaction.tx_signed_inputs;
+    uint8_t signed_bit = (uint8_t) (1 << (input_index % 8));
+    if ((signed_inputs[input_index / 8] & signed_bit) != 0) {
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    G_context.tx_info.signing_input_index = input_index;
+
+    int error = crypto_sign_transaction(&txin);
+    if (error != 0) {
         G_context.state = STATE_NONE;
+        crypto_wipe_derived_keys();
+        return io_send_sw(error);
+    }
 
-        parser_status_e status =
-            transaction_deserialize(cdata, &G_context.tx_info.transaction, G_context.bip32_path);
+    context_mark_inputs(input_index / 8 + 1);
+    signed_inputs[input_index / 8] |= signed_bit;
+    G_context.tx_info.signing_position++;
 
-        PRINTF("Header Parsing status: %d.\n", status);
+    if (G_context.tx_info.signing_position >= G_context.tx_info.transaction.tx_input_len) {
+        // Every input is signed, nothing is left to use the keys for
+        crypto_wipe_derived_keys();
+        G_context.state = STATE_NONE;
+    }
 
-        if (status != PARSING_OK) {
-            return io_send_sw(SW_TX_PARSING_FAIL);
+    return helper_send_response_streamed_sig();
+}
+
+/**
+ * Parse the inputs of a P1_INPUTS APDU, as many records of
+ * SERIALIZED_INPUT_LEN bytes as the APDU holds, and add them to the digests.
+ *
+ * @return SW_OK if success, the status word to send otherwise.
+ */
+static uint16_t parse_inputs(const buffer_t *cdata) {
+    transaction_ctx_t *tx_info = &G_context.tx_info;
+
+    if (cdata->size == 0 || cdata->size % SERIALIZED_INPUT_LEN != 0) {
+        return SW_TX_PARSING_FAIL;
+    }
+
+    size_t count = cdata->size / SERIALIZED_INPUT_LEN;
+
+    // Every record is checked to fit before the first one is hashed
+    if (count > MAX_INPUTS_PER_APDU ||
+        count > tx_info->transaction.tx_input_len - tx_info->parsing_input_index ||
+        (!tx_info->streamed && tx_info->parsing_input_index + count > MAX_INPUT_COUNT)) {
+        // Too many inputs!
+        return SW_TX_PARSING_FAIL;
+    }
+
+    tx_info->commitments_len = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *record = cdata->ptr + i * SERIALIZED_INPUT_LEN;
+
+        // Streamed inputs are only hashed and committed to, not stored
+        transaction_input_t streamed_input = {0};
+        transaction_input_t *txin = &streamed_input;
+        if (!tx_info->streamed) {
+            context_mark_inputs((tx_info->parsing_input_index + 1) * sizeof(transaction_input_t));
+            txin = &tx_info->transaction.tx_inputs[tx_info->parsing_input_index];
+        }
+
+        // The record is read in place and decoded straight into its slot
+        parser_status_e err =
+            transaction_input_deserialize_record(record, SERIALIZED_INPUT_LEN, txin);
+
+        PRINTF("Input Parsing status: %d.\n", err);
+
+        if (err < 0) {
+            return SW_TX_PARSING_FAIL;
         }
 
-        return io_send_sw(SW_OK);
+        // No valid transaction has inputs worth more than a uint64_t
+        if (!add_to_total(&tx_info->input_total, txin->value)) {
+            return SW_TX_PARSING_FAIL;
+        }
 
-    } else if (type == 1 || type == 2) {  // parse transaction
+        if (!sighash_cache_add_input(&tx_info->sighash_cache, txin)) {
+            return SW_TX_HASH_FAIL;
+        }
+
+        if (tx_info->streamed) {
+            if (!calc_input_commitment(tx_info->session_key,
+                                       tx_info->parsing_input_index,
+                                       record,
+                                       SERIALIZED_INPUT_LEN,
+                                       tx_info->commitments[tx_info->commitments_len],
+                                       INPUT_COMMITMENT_LEN)) {
+                return SW_TX_HASH_FAIL;
+            }
+            tx_info->commitments_len++;
+        }
+
+        tx_info->parsing_input_index++;
+    }
+
+    return SW_OK;
+}
+
+int handler_sign_tx(buffer_t *cdata, uint8_t type, bool more) {
+    if (type == P1_START || type == P1_START_STREAMED) {
+        return start_transaction(cdata, type == P1_START_STREAMED);
 
-        if (G_context.req_type != CONFIRM_TRANSACTION) {
+    } else if (type == P1_OUTPUTS || type == P1_INPUTS) {  // parse transaction
+
+        if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_NONE) {
             return io_send_sw(SW_BAD_STATE);
         }
 
@@ -88,69 +315,125 @@ int handler_sign_tx(buffer_t *cdata, uint8_t type, bool more) {
                 return io_send_sw(SW_TX_PARSING_FAIL);
             }
 
-            parser_status_e err = transaction_output_deserialize(
-                cdata,
-                &G_context.tx_info.transaction.tx_outputs[G_context.tx_info.parsing_output_index]);
+            transaction_output_t txout = {0};
+            parser_status_e err =
+                transaction_output_deserialize(cdata,
+                                               &txout,
+                                               &G_context.tx_info.transaction.tx_scripts);
 
             PRINTF("Output Parsing status: %d.\n", err);
 
             if (err != PARSING_OK) {
                 return io_send_sw(err);
-            } else {
-                G_context.tx_info.parsing_output_index++;
             }
 
-        } else if (type == P1_INPUTS) {
-            // Inputs
-            if (G_context.tx_info.parsing_input_index >= (uint8_t) MAX_INPUT_COUNT ||
-                G_context.tx_info.parsing_input_index >=
-                    (uint8_t) G_context.tx_info.transaction.tx_input_len) {
-                // Too many inputs!
+            if (!add_to_total(&G_context.tx_info.output_total, txout.value)) {
+                // Give the script's room in the arena back
+                G_context.tx_info.transaction.tx_scripts.len = txout.script_offset;
                 return io_send_sw(SW_TX_PARSING_FAIL);
             }
 
-            parser_status_e err = transaction_input_deserialize(
-                cdata,
-                &G_context.tx_info.transaction.tx_inputs[G_context.tx_info.parsing_input_index]);
+            // The script is already in tx_scripts, see transaction_t
+            transaction_t *tx = &G_context.tx_info.transaction;
+            tx->tx_output_values[G_context.tx_info.parsing_output_index] = txout.value;
+            tx->tx_output_script_offsets[G_context.tx_info.parsing_output_index] =
+                txout.script_offset;
+            tx->tx_output_script_lens[G_context.tx_info.parsing_output_index] = txout.script_len;
 
-            PRINTF("Input Parsing status: %d.\n", err);
-
-            if (err < 0) {
-                return io_send_sw(SW_TX_PARSING_FAIL);
-            } else {
-                G_context.tx_info.parsing_input_index++;
-            }
+            G_context.tx_info.parsing_output_index++;
 
         } else {
-            return io_send_sw(SW_WRONG_P1P2);
+            // Inputs
+            uint16_t sw = parse_inputs(cdata);
+            if (sw != SW_OK) {
+                return io_send_sw(sw);
+            }
         }
 
         if (more) {
             // more APDUs with transaction part are expected.
+            if (type == P1_INPUTS && G_context.tx_info.streamed) {
+                // The host keeps the commitments to re-send the inputs for signing
+                return io_send_response_pointer(
+                    G_context.tx_info.commitments[0],
+                    G_context.tx_info.commitments_len * INPUT_COMMITMENT_LEN,
+                    SW_OK);
+            }
             // Send a SW_OK to signal that we have received the chunk
             return io_send_sw(SW_OK);
 
         } else {
             // Before asking the user, make sure one last time that the inputs are legitimate:
-            if (!tx_validate_parsed_transaction(&G_context.tx_info.transaction)) {
+            if (!tx_validate_parsed_transaction(&G_context.tx_info.transaction,
+                                                G_context.tx_info.input_total,
+                                                G_context.tx_info.output_total)) {
+                return io_send_sw(SW_TX_PARSING_FAIL);
+            }
+
+            // The running digests only cover what was received
+            if (G_context.tx_info.parsing_input_index !=
+                    G_context.tx_info.transaction.tx_input_len ||
+                G_context.tx_info.parsing_output_index !=
+                    G_context.tx_info.transaction.tx_output_len) {
                 return io_send_sw(SW_TX_PARSING_FAIL);
             }
 
+            if (!G_context.tx_info.streamed) {
+                // Inputs paying to the same address are signed back to back
+                // so that their key is derived once
+                group_inputs_by_path(G_context.tx_info.transaction.tx_inputs,
+                                     G_context.tx_info.transaction.tx_input_len,
+                                     G_context.tx_info.signing_order);
+            }
+
             // last APDU for this transaction, let's parse, display and request a sign confirmation
             G_context.state = STATE_PARSED;
 
+            // The transaction-wide digests and the keys are worked on while
+            // the user reviews, see precompute.h
+            precompute_start();
+
             return ui_display_transaction();
         }
-    } else if (type == 3) {
-        if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_APPROVED) {
-            explicit_bzero(&G_context, sizeof(G_context));
+    } else if (type == P1_NEXT_SIGNATURE || type == P1_NEXT_SIGNATURES || type == P1_SIGN_INPUT) {
+        if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_APPROVED ||
+            G_context.tx_info.streamed != (type == P1_SIGN_INPUT)) {
+            context_reset();
             G_context.state = STATE_NONE;
             return io_send_sw(SW_BAD_STATE);
         }
 
+        if (type == P1_SIGN_INPUT) {
+            return sign_streamed_input(cdata);
+        }
+
+        if (type == P1_NEXT_SIGNATURES) {
+            uint8_t flags = 0;
+            if (!buffer_read_u8(cdata, &flags)) {
+                return io_send_sw(SW_WRONG_DATA_LENGTH);
+            }
+
+            if (G_context.tx_info.sign_eagerly) {
+                // Only the signatures were kept
+                if ((flags & NEXT_SIGNATURES_NO_SIGHASH) == 0 ||
+                    G_context.tx_info.signing_position >=
+                        G_context.tx_info.transaction.tx_input_len) {
+                    return io_send_sw(SW_BAD_STATE);
+                }
+                return helper_send_response_sig_table();
+            }
+
+            return sign_inputs_and_send((flags & NEXT_SIGNATURES_NO_SIGHASH) == 0);
+        }
+
+        if (G_context.tx_info.sign_eagerly) {
+            // Signatures are fetched with P1_NEXT_SIGNATURES
+            return io_send_sw(SW_BAD_STATE);
+        }
+
         sign_input_and_send();
     } else {
-        explicit_bzero(&G_context, sizeof(G_context));
+        context_reset();
         G_context.state = STATE_NONE;
         return io_send_sw(SW_WRONG_P1P2);
     }
@@ -0,0 +1,219 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "./hash.h"
+
+#ifdef USE_CX_BLAKE2B
+// The BLAKE2b state inside an SDK hash context
+#define WRITER_STATE(hash) (&(hash)->ctx)
+
+// The documented cx_hash API has no keyed BLAKE2b and no way to add a few
+// bytes without a call per field. hash_init therefore loads a precomputed
+// state into cx_blake2b_t.ctx, and the hash_write_* helpers append to
+// ctx.buf and ctx.buflen directly. These fields come from lcx_blake2.h and
+// must keep the layout of the BLAKE2 reference state, which the
+// precomputed states below are written for. The build stops here if an SDK
+// update changes them.
+_Static_assert(sizeof(((cx_blake2b_t*) 0)->ctx) == sizeof(blake2b_state),
+               "cx_blake2b_t.ctx is no longer a blake2b_state");
+_Static_assert(sizeof(((blake2b_state*) 0)->h) == 8 * sizeof(uint64_t) &&
+                   offsetof(blake2b_state, h) == 0,
+               "blake2b_state.h is not the 8-word chaining value");
+_Static_assert(sizeof(((blake2b_state*) 0)->t) == 2 * sizeof(uint64_t) &&
+                   offsetof(blake2b_state, t) == offsetof(blake2b_state, h) + 8 * sizeof(uint64_t),
+               "blake2b_state.t is not the 2-word counter after h");
+_Static_assert(sizeof(((blake2b_state*) 0)->buf) == BLAKE2B_BLOCKBYTES,
+               "blake2b_state.buf is not one BLAKE2b block");
+_Static_assert(offsetof(blake2b_state, buflen) == offsetof(blake2b_state, buf) + BLAKE2B_BLOCKBYTES,
+               "blake2b_state.buflen does not follow buf");
+_Static_assert(sizeof(((blake2b_state*) 0)->buflen) == sizeof(size_t) &&
+                   sizeof(((blake2b_state*) 0)->outlen) == sizeof(size_t),
+               "blake2b_state.buflen or outlen is not a size_t");
+#else
+#define WRITER_STATE(hash) (hash)
+#endif
+
+// BLAKE2b-256 state after the key block of SIGNING_KEY was compressed
+static const blake2b_state TX_SIGNING_HASH_STATE = {
+    .h = {0xa1f262d8452f7944ULL,
+          0xa0c8b06e8fc22fe0ULL,
+          0xdfc64e0f0abc65e6ULL,
+          0xfc7f6ae21f29953fULL,
+          0x8e5ddbf833addef9ULL,
+          0xb0fdcb71ba2162beULL,
+          0x9215ad9b69ac9b9aULL,
+          0x0218557f8b2f7d32ULL},
+    .t = {BLAKE2B_BLOCKBYTES, 0},
+    .outlen = 32,
+};
+
+// BLAKE2b-256 state after the key block of MESSAGE_SIGNING_KEY was compressed
+static const blake2b_state MESSAGE_SIGNING_HASH_STATE = {
+    .h = {0xc3282055b86cb295ULL,
+          0x2e3156718bd8e88aULL,
+          0x6a2747b07d6c64f7ULL,
+          0x538c7122bf31b3c2ULL,
+          0x68333870794c5e26ULL,
+          0x5bf3acf8085e872fULL,
+          0x3546817842839673ULL,
+          0xe4cc01987e0cb214ULL},
+    .t = {BLAKE2B_BLOCKBYTES, 0},
+    .outlen = 32,
+};
+
+// BLAKE2b-256 state after the key block of INPUT_COMMITMENT_KEY was compressed
+static const blake2b_state INPUT_COMMITMENT_HASH_STATE = {
+    .h = {0x384dadb1f9f36b0fULL,
+          0x73a0cb1ddcc925daULL,
+          0xd25e683fc2889101ULL,
+          0x5bcfd614056c0ac5ULL,
+          0xe5c6f80e2e2e43a4ULL,
+          0x07bce89cd1b256e2ULL,
+          0xc737487a7973695bULL,
+          0xa3b2e769eb4422aeULL},
+    .t = {BLAKE2B_BLOCKBYTES, 0},
+    .outlen = 32,
+};
+
+static const blake2b_state* domain_state(hash_domain_e domain) {
+    switch (domain) {
+        case TX_SIGNING_HASH:
+            return &TX_SIGNING_HASH_STATE;
+        case MESSAGE_SIGNING_HASH:
+            return &MESSAGE_SIGNING_HASH_STATE;
+        case INPUT_COMMITMENT_HASH:
+            return &INPUT_COMMITMENT_HASH_STATE;
+        default:
+            return NULL;
+    }
+}
+
+bool hash_init(hash_writer_t* hash, hash_domain_e domain) {
+    const blake2b_state* state = domain_state(domain);
+    if (state == NULL) {
+        return false;
+    }
+
+#ifdef USE_CX_BLAKE2B
+    if (cx_blake2b_init_no_throw(hash, 256) != CX_OK) {
+        return false;
+    }
+    // cx_blake2b has no keyed mode, resume from the precomputed state instead
+#endif
+    *WRITER_STATE(hash) = *state;
+    return true;
+}
+
+bool hash_update(hash_writer_t* hash, const uint8_t* data, size_t len) {
+#ifdef USE_CX_BLAKE2B
+    return cx_hash_no_throw((cx_hash_t*) hash, CX_NONE, data, len, NULL, 0) == CX_OK;
+#else
+    // blake2b_update currently always returns 0
+    return blake2b_update(hash, data, len) == 0;
+#endif
+}
+
+// Claim len bytes of the writer's block buffer, NULL if they don't fit
+static uint8_t* reserve(hash_writer_t* hash, size_t len) {
+    blake2b_state* state = WRITER_STATE(hash);
+
+    if (state->buflen + len > BLAKE2B_BLOCKBYTES) {
+        return NULL;
+    }
+
+    uint8_t* out = state->buf + state->buflen;
+    state->buflen += len;
+    return out;
+}
+
+static bool write_le(hash_writer_t* hash, uint64_t value, size_t len) {
+    uint8_t buffer[8];
+    uint8_t* out = reserve(hash, len);
+
+    if (out == NULL) {
+        // Crosses a block boundary, let the hash update compress the full block
+        out = buffer;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        out[i] = (uint8_t) (value >> (8 * i));
+    }
+
+    return out != buffer || hash_update(hash, buffer, len);
+}
+
+bool hash_write_u8(hash_writer_t* hash, uint8_t value) {
+    return write_le(hash, value, 1);
+}
+
+bool hash_write_u16_le(hash_writer_t* hash, uint16_t value) {
+    return write_le(hash, value, 2);
+}
+
+bool hash_write_u32_le(hash_writer_t* hash, uint32_t value) {
+    return write_le(hash, value, 4);
+}
+
+bool hash_write_u64_le(hash_writer_t* hash, uint64_t value) {
+    return write_le(hash, value, 8);
+}
+
+bool hash_write_zeros(hash_writer_t* hash, size_t len) {
+    static const uint8_t zeros[32] = {0};
+
+    while (len > 0) {
+        size_t chunk = len < sizeof(zeros) ? len : sizeof(zeros);
+        uint8_t* out = reserve(hash, chunk);
+
+        if (out != NULL) {
+            memset(out, 0, chunk);
+        } else if (!hash_update(hash, zeros, chunk)) {
+            return false;
+        }
+        len -= chunk;
+    }
+
+    return true;
+}
+
+bool hash_finalize(hash_writer_t* hash, uint8_t* out, size_t out_len) {
+    if (out_len < 32) {
+        return false;
+    }
+    // The key block is already compressed in the precomputed states so the
+    // last block must come from data written after hash_init
+    if (WRITER_STATE(hash)->buflen == 0) {
+        return false;
+    }
+#ifdef USE_CX_BLAKE2B
+    return cx_hash_no_throw((cx_hash_t*) hash, CX_LAST, NULL, 0, out, 32) == CX_OK;
+#else
+    // blake2b_final returns 0 for success and -1 for any error
+    return blake2b_final(hash, out, 32) == 0;
+#endif
+}
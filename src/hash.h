@@ -0,0 +1,99 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#pragma once
+
+#include <stdint.h>   // uint*_t
+#include <stddef.h>   // size_t
+#include <stdbool.h>  // bool
+
+#ifdef USE_CX_BLAKE2B
+#include "cx.h"
+
+/**
+ * Hash writer backed by the SDK's BLAKE2b (cx_blake2b).
+ */
+typedef cx_blake2b_t hash_writer_t;
+#else
+#include "./import/blake2b.h"
+
+/**
+ * Hash writer backed by the vendored BLAKE2b in src/import.
+ */
+typedef blake2b_state hash_writer_t;
+#endif
+
+/**
+ * Enumeration of the keyed BLAKE2b domains used by the app.
+ */
+typedef enum {
+    TX_SIGNING_HASH,       /// keyed with SIGNING_KEY
+    MESSAGE_SIGNING_HASH,  /// keyed with MESSAGE_SIGNING_KEY
+    INPUT_COMMITMENT_HASH  /// keyed with INPUT_COMMITMENT_KEY
+} hash_domain_e;
+
+/**
+ * Start a 256-bit keyed BLAKE2b hash for the given domain.
+ *
+ * The state right after the key block is compressed is precomputed for
+ * each domain, so this is a struct copy instead of a keyed init. As the
+ * key block has already been compressed, at least one byte of data must
+ * be written before hash_finalize.
+ *
+ * @param[out] hash
+ *   The hash writer to initialize
+ * @param[in]  domain
+ *   The domain the hash is computed for
+ *
+ * @return true if success, false otherwise.
+ */
+bool hash_init(hash_writer_t* hash, hash_domain_e domain);
+
+/**
+ * Write data to the hash writer.
+ *
+ * @return true if success, false otherwise.
+ */
+bool hash_update(hash_writer_t* hash, const uint8_t* data, size_t len);
+
+/**
+ * Write little-endian integers and runs of zero bytes to the hash writer.
+ *
+ * BLAKE2b only compresses its 128-byte block buffer once more data
+ * arrives, so while a field fits in the buffer it is stored there
+ * directly, without a scratch buffer or a call into the hash update.
+ *
+ * @return true if success, false otherwise.
+ */
+bool hash_write_u8(hash_writer_t* hash, uint8_t value);
+bool hash_write_u16_le(hash_writer_t* hash, uint16_t value);
+bool hash_write_u32_le(hash_writer_t* hash, uint32_t value);
+bool hash_write_u64_le(hash_writer_t* hash, uint64_t value);
+bool hash_write_zeros(hash_writer_t* hash, size_t len);
+
+/**
+ * Write the 32-byte digest of the hash writer to out.
+ *
+ * @return true if success, false otherwise.
+ */
+bool hash_finalize(hash_writer_t* hash, uint8_t* out, size_t out_len);
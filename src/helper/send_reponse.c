@@ -46,13 +46,26 @@ int helper_send_response_pubkey() {
     return io_send_response_pointer(resp, offset, SW_OK);
 }
 
+int helper_send_response_pubkeys(const uint8_t (*public_keys)[32], uint8_t count) {
+    uint8_t resp[1 + PUBKEYS_MAX_COUNT * 32] = {0};
+    size_t offset = 0;
+
+    // count -> 1 byte
+    resp[offset++] = count;
+    // public_keys -> 32 bytes each
+    memmove(resp + offset, public_keys, (size_t) count * 32);
+    offset += (size_t) count * 32;
+
+    return io_send_response_pointer(resp, offset, SW_OK);
+}
+
 int helper_send_response_sig() {
     uint8_t resp[3 + MAX_DER_SIG_LEN + 34] = {0};
     size_t offset = 0;
 
     // has_more -> 1 byte
     resp[offset++] =
-        G_context.tx_info.transaction.tx_input_len - G_context.tx_info.signing_input_index - 1;
+        G_context.tx_info.transaction.tx_input_len - G_context.tx_info.signing_position - 1;
     // input_index -> 1 byte
     resp[offset++] = G_context.tx_info.signing_input_index;
     // len(sig) -> 1 byte
@@ -69,6 +82,79 @@ int helper_send_response_sig() {
     return io_send_response_pointer(resp, offset, SW_OK);
 }
 
+size_t helper_write_sig_record(uint8_t *out,
+                               uint8_t input_index,
+                               const uint8_t *signature,
+                               const uint8_t *sighash) {
+    size_t offset = 0;
+
+    // input_index -> 1 byte
+    out[offset++] = input_index;
+    // len(sig) -> 1 byte
+    out[offset++] = MAX_DER_SIG_LEN;
+    // sig -> 64 bytes
+    memmove(out + offset, signature, MAX_DER_SIG_LEN);
+    offset += MAX_DER_SIG_LEN;
+
+    if (sighash != NULL) {
+        // len(sighash) -> 1 byte
+        out[offset++] = sizeof(G_context.tx_info.sighash);
+        // sighash -> 32 bytes
+        memmove(out + offset, sighash, sizeof(G_context.tx_info.sighash));
+        offset += sizeof(G_context.tx_info.sighash);
+    }
+
+    return offset;
+}
+
+int helper_send_response_sig_table() {
+    // Built where it is sent from instead of on the stack, as in sign_tx.c
+    uint8_t *resp = G_io_apdu_buffer;
+    size_t offset = 2;
+    uint8_t count = 0;
+    transaction_ctx_t *tx_info = &G_context.tx_info;
+
+    while (tx_info->signing_position < tx_info->transaction.tx_input_len &&
+           offset + SIG_RECORD_LEN(false) <= IO_APDU_BUFFER_SIZE - 2) {
+        uint16_t position = tx_info->signing_position;
+
+        offset += helper_write_sig_record(resp + offset,
+                                          tx_info->signing_order[position],
+                                          tx_info->transaction.tx_signatures[position],
+                                          NULL);
+        tx_info->signing_position++;
+        count++;
+    }
+
+    // has_more -> 1 byte
+    resp[0] = tx_info->transaction.tx_input_len - tx_info->signing_position;
+    // count -> 1 byte
+    resp[1] = count;
+
+    return io_send_response_pointer(resp, offset, SW_OK);
+}
+
+int helper_send_response_streamed_sig() {
+    uint8_t resp[4 + MAX_DER_SIG_LEN + 32] = {0};
+    size_t offset = 0;
+
+    // input_index -> 2 bytes, big endian
+    resp[offset++] = (uint8_t) (G_context.tx_info.signing_input_index >> 8);
+    resp[offset++] = (uint8_t) G_context.tx_info.signing_input_index;
+    // len(sig) -> 1 byte
+    resp[offset++] = MAX_DER_SIG_LEN;
+    // sig -> 64 bytes
+    memmove(resp + offset, G_context.tx_info.signature, MAX_DER_SIG_LEN);
+    offset += MAX_DER_SIG_LEN;
+    // len(sighash) -> 1 byte
+    resp[offset++] = sizeof(G_context.tx_info.sighash);
+    // sighash -> 32 bytes
+    memmove(resp + offset, G_context.tx_info.sighash, sizeof(G_context.tx_info.sighash));
+    offset += sizeof(G_context.tx_info.sighash);
+
+    return io_send_response_pointer(resp, offset, SW_OK);
+}
+
 int helper_send_response_personal_message_sig() {
     uint8_t resp[3 + MAX_DER_SIG_LEN + 34] = {0};
     size_t offset = 0;
@@ -23,6 +23,10 @@
  *****************************************************************************/
 #pragma once
 
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+
 #include "os.h"
 #include "macros.h"
 
@@ -34,6 +38,16 @@
  * Length of chain code.
  */
 #define CHAINCODE_LEN (MEMBER_SIZE(pubkey_ctx_t, chain_code))
+/**
+ * Maximum number of public keys sent back by GET_PUBLIC_KEYS,
+ * count (1) || public_keys (32 each) must fit in the response.
+ */
+#define PUBKEYS_MAX_COUNT ((IO_APDU_BUFFER_SIZE - 2 - 1) / 32)
+/**
+ * Length of a signature record, with or without its sighash.
+ */
+#define SIG_RECORD_LEN(with_sighash) \
+    (1 + 1 + MAX_DER_SIG_LEN + ((with_sighash) ? 1 + MEMBER_SIZE(transaction_ctx_t, sighash) : 0))
 
 /**
  * Helper to send APDU response with public key and chain code.
@@ -48,6 +62,23 @@
  */
 int helper_send_response_pubkey(void);
 
+/**
+ * Helper to send APDU response with the x-coordinates of several
+ * public keys.
+ *
+ * response = count (1) ||
+ *            public_keys (32 * count)
+ *
+ * @param[in] public_keys
+ *   The public keys, at most PUBKEYS_MAX_COUNT.
+ * @param[in] count
+ *   Number of public keys.
+ *
+ * @return zero or positive integer if success, -1 otherwise.
+ *
+ */
+int helper_send_response_pubkeys(const uint8_t (*public_keys)[32], uint8_t count);
+
 /**
  * Helper to send APDU response with signature and v (parity of
  * y-coordinate of R).
@@ -60,6 +91,61 @@ int helper_send_response_pubkey(void);
  */
 int helper_send_response_sig(void);
 
+/**
+ * Helper to write the record of a signature, several of them are sent
+ * back at once for P1_NEXT_SIGNATURES.
+ *
+ * record = input_index (1) ||
+ *          MAX_DER_SIG_LEN (1) ||
+ *          signature (MAX_DER_SIG_LEN) ||
+ *          [len(sighash) (1) ||
+ *          sighash (32)]
+ *
+ * @param[out] out
+ *   Where the record is written, at least SIG_RECORD_LEN(sighash != NULL) bytes.
+ * @param[in]  input_index
+ *   Index of the signed input.
+ * @param[in]  signature
+ *   Signature of the input, MAX_DER_SIG_LEN bytes.
+ * @param[in]  sighash
+ *   Sighash that was signed, NULL to leave it out of the record.
+ *
+ * @return length of the record.
+ *
+ */
+size_t helper_write_sig_record(uint8_t *out,
+                               uint8_t input_index,
+                               const uint8_t *signature,
+                               const uint8_t *sighash);
+
+/**
+ * Helper to send APDU response with as many signatures from
+ * G_context.tx_info.transaction.tx_signatures as fit, starting at
+ * G_context.tx_info.signing_position which is moved past them.
+ *
+ * response = has_more (1) ||
+ *            count (1) ||
+ *            count records without sighash, see helper_write_sig_record
+ *
+ * @return zero or positive integer if success, -1 otherwise.
+ *
+ */
+int helper_send_response_sig_table(void);
+
+/**
+ * Helper to send APDU response with the signature of a streamed input.
+ *
+ * response = input_index (2) ||
+ *            MAX_DER_SIG_LEN (1) ||
+ *            G_context.tx_info.signature (MAX_DER_SIG_LEN) ||
+ *            len(sighash) (1) ||
+ *            G_context.tx_info.sighash (32)
+ *
+ * @return zero or positive integer if success, -1 otherwise.
+ *
+ */
+int helper_send_response_streamed_sig(void);
+
 /**
  * Helper to send APDU response with personal message signature
  * response = MAX_DER_SIG_LEN (1) ||
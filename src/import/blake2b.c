@@ -30,6 +30,7 @@ static const uint64_t blake2b_IV[8] =
   0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
 };
 
+#ifndef BLAKE2B_UNROLLED
 static const uint8_t blake2b_sigma[12][16] =
 {
   {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 } ,
@@ -45,6 +46,7 @@ static const uint8_t blake2b_sigma[12][16] =
   {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 } ,
   { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 }
 };
+#endif
 
 
 static void blake2b_set_lastnode( blake2b_state *S )
@@ -151,6 +153,93 @@ int blake2b_init_key( blake2b_state *S, size_t outlen, const void *key, size_t k
   return 0;
 }
 
+#ifdef BLAKE2B_UNROLLED
+/*
+ * Unrolled kernel: the sigma permutation of every round is passed as
+ * literal message word indices so no table lookup is left at run time,
+ * and the working vector lives in locals the compiler can keep in
+ * registers. Selected with the BLAKE2B_UNROLLED define.
+ */
+
+/* Rotation by a constant distance, compiled to native rotates */
+#define ROTR64(w, c) ( ( (w) >> (c) ) | ( (w) << ( 64 - (c) ) ) )
+
+#define G(a,b,c,d,x,y)          \
+  do {                          \
+    a = a + b + (x);            \
+    d = ROTR64(d ^ a, 32);      \
+    c = c + d;                  \
+    b = ROTR64(b ^ c, 24);      \
+    a = a + b + (y);            \
+    d = ROTR64(d ^ a, 16);      \
+    c = c + d;                  \
+    b = ROTR64(b ^ c, 63);      \
+  } while(0)
+
+#define ROUND(s0,s1,s2,s3,s4,s5,s6,s7,s8,s9,s10,s11,s12,s13,s14,s15) \
+  do {                                                                \
+    G(v0, v4, v8,  v12, m[s0],  m[s1]);                               \
+    G(v1, v5, v9,  v13, m[s2],  m[s3]);                               \
+    G(v2, v6, v10, v14, m[s4],  m[s5]);                               \
+    G(v3, v7, v11, v15, m[s6],  m[s7]);                               \
+    G(v0, v5, v10, v15, m[s8],  m[s9]);                               \
+    G(v1, v6, v11, v12, m[s10], m[s11]);                              \
+    G(v2, v7, v8,  v13, m[s12], m[s13]);                              \
+    G(v3, v4, v9,  v14, m[s14], m[s15]);                              \
+  } while(0)
+
+static void blake2b_compress( blake2b_state *S, const uint8_t block[BLAKE2B_BLOCKBYTES] )
+{
+#define m b2bg_cx.m
+  size_t i;
+
+  for( i = 0; i < 16; ++i ) {
+    m[i] = load64( block + i * sizeof( m[i] ) );
+  }
+
+  uint64_t v0  = S->h[0];
+  uint64_t v1  = S->h[1];
+  uint64_t v2  = S->h[2];
+  uint64_t v3  = S->h[3];
+  uint64_t v4  = S->h[4];
+  uint64_t v5  = S->h[5];
+  uint64_t v6  = S->h[6];
+  uint64_t v7  = S->h[7];
+  uint64_t v8  = blake2b_IV[0];
+  uint64_t v9  = blake2b_IV[1];
+  uint64_t v10 = blake2b_IV[2];
+  uint64_t v11 = blake2b_IV[3];
+  uint64_t v12 = blake2b_IV[4] ^ S->t[0];
+  uint64_t v13 = blake2b_IV[5] ^ S->t[1];
+  uint64_t v14 = blake2b_IV[6] ^ S->f[0];
+  uint64_t v15 = blake2b_IV[7] ^ S->f[1];
+
+  ROUND(  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 );
+  ROUND( 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 );
+  ROUND( 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 );
+  ROUND(  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 );
+  ROUND(  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 );
+  ROUND(  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 );
+  ROUND( 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 );
+  ROUND( 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 );
+  ROUND(  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 );
+  ROUND( 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 );
+  ROUND(  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 );
+  ROUND( 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 );
+
+  S->h[0] ^= v0 ^ v8;
+  S->h[1] ^= v1 ^ v9;
+  S->h[2] ^= v2 ^ v10;
+  S->h[3] ^= v3 ^ v11;
+  S->h[4] ^= v4 ^ v12;
+  S->h[5] ^= v5 ^ v13;
+  S->h[6] ^= v6 ^ v14;
+  S->h[7] ^= v7 ^ v15;
+#undef m
+}
+
+#undef ROTR64
+#else
 #define G(r,i,a,b,c,d)                      \
   do {                                      \
     a = a + b + m[blake2b_sigma[r][2*i+0]]; \
@@ -219,6 +308,7 @@ static void blake2b_compress( blake2b_state *S, const uint8_t block[BLAKE2B_BLOC
 #undef m
 #undef v
 }
+#endif
 
 #undef G
 #undef ROUND
@@ -0,0 +1,88 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "./input_commitment.h"
+#include "./hash.h"
+
+bool calc_input_commitment(const uint8_t* session_key,
+                           uint16_t input_index,
+                           const uint8_t* input,
+                           size_t input_len,
+                           uint8_t* out,
+                           size_t out_len) {
+    hash_writer_t hash;
+
+    if (out_len < INPUT_COMMITMENT_LEN) {
+        return false;
+    }
+
+    if (!hash_init(&hash, INPUT_COMMITMENT_HASH)) {
+        return false;
+    }
+
+    // BLAKE2b is not subject to length extension so prefixing the
+    // secret key is enough to make this a MAC
+    if (!hash_update(&hash, session_key, INPUT_COMMITMENT_SESSION_LEN)) {
+        return false;
+    }
+
+    // Input index, big endian, 2 bytes
+    if (!hash_write_u8(&hash, (uint8_t) (input_index >> 8)) ||
+        !hash_write_u8(&hash, (uint8_t) input_index)) {
+        return false;
+    }
+
+    if (!hash_update(&hash, input, input_len)) {
+        return false;
+    }
+
+    return hash_finalize(&hash, out, out_len);
+}
+
+bool check_input_commitment(const uint8_t* session_key,
+                            uint16_t input_index,
+                            const uint8_t* input,
+                            size_t input_len,
+                            const uint8_t* commitment) {
+    uint8_t expected[INPUT_COMMITMENT_LEN] = {0};
+    uint8_t diff = 0;
+
+    if (!calc_input_commitment(session_key,
+                               input_index,
+                               input,
+                               input_len,
+                               expected,
+                               sizeof(expected))) {
+        return false;
+    }
+
+    for (size_t i = 0; i < sizeof(expected); i++) {
+        diff |= expected[i] ^ commitment[i];
+    }
+
+    return diff == 0;
+}
@@ -0,0 +1,74 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#pragma once
+
+#include <stddef.h>   // size_t
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+
+#define INPUT_COMMITMENT_LEN         32
+#define INPUT_COMMITMENT_SESSION_LEN 32
+
+/**
+ * Calculate the commitment to a streamed input.
+ *
+ * When inputs are streamed they are not kept in RAM. Each one is
+ * answered with this commitment, a BLAKE2b MAC over its index and its
+ * serialized bytes keyed with a random per-transaction session key.
+ * When the host re-sends the input for signing, it has to send the
+ * commitment back. The device recomputes the commitment, so the input
+ * can't differ from the one that was reviewed.
+ *
+ * @param[in]  session_key
+ *   Random key of the transaction, never leaves the device
+ * @param[in]  input_index
+ *   Index of the input in the transaction
+ * @param[in]  input
+ *   Serialized input as received in the APDU
+ * @param[in]  input_len
+ *   Length of the serialized input
+ * @param[out] out
+ *   Where the commitment is written
+ * @param[in]  out_len
+ *   Length of out, at least INPUT_COMMITMENT_LEN
+ *
+ * @return true if success, false otherwise.
+ */
+bool calc_input_commitment(const uint8_t* session_key,
+                           uint16_t input_index,
+                           const uint8_t* input,
+                           size_t input_len,
+                           uint8_t* out,
+                           size_t out_len);
+
+/**
+ * Check a commitment sent back by the host, in constant time.
+ *
+ * @return true if the commitment matches the input, false otherwise.
+ */
+bool check_input_commitment(const uint8_t* session_key,
+                            uint16_t input_index,
+                            const uint8_t* input,
+                            size_t input_len,
+                            const uint8_t* commitment);
@@ -25,58 +25,36 @@
 #include <stdbool.h>
 
 #include "constants.h"
-#include "./import/blake2-impl.h"
-#include "./import/blake2b.h"
 #include "./personal_message.h"
+#include "./hash.h"
 
-static bool hash_init(blake2b_state* hash, size_t size, uint8_t* key, size_t key_len) {
-    if (key == NULL && key_len != 0) {
-        goto err;
-    }
-
-    if (size % 8 != 0 || size < 8 || size > 512) {
-        goto err;
-    }
-    memset(hash, 0, sizeof(blake2b_state));
-
-    size = size / 8;
+bool personal_message_hash_init(hash_writer_t* hash) {
+    return hash_init(hash, MESSAGE_SIGNING_HASH);
+}
 
-    if (blake2b_init_key(hash, size, key, key_len) < 0) {
-        goto err;
+bool personal_message_hash_update(hash_writer_t* hash, const uint8_t* chunk, size_t chunk_len) {
+    if (chunk_len == 0) {
+        return false;
     }
-    return true;
-
-err:
-    return false;
-}
 
-static bool hash_update(blake2b_state* hash, uint8_t* data, size_t len) {
-    return blake2b_update(hash, data, len) == 0;
+    return hash_update(hash, chunk, chunk_len);
 }
 
-static bool hash_finalize(blake2b_state* hash, uint8_t* out, size_t out_len) {
+bool personal_message_hash_finalize(hash_writer_t* hash, uint8_t* out_hash, size_t out_len) {
     if (out_len < 32) {
         return false;
     }
-    return blake2b_final(hash, out, 32) == 0;
+
+    return hash_finalize(hash, out_hash, out_len);
 }
 
 bool hash_personal_message(uint8_t* message_bytes,
                            size_t message_byte_len,
                            uint8_t* out_hash,
                            size_t out_len) {
-    if (out_len < 32) {
-        return false;
-    }
-
-    blake2b_state inner_hash_writer;
-    if (!hash_init(&inner_hash_writer, 256, (uint8_t*) MESSAGE_SIGNING_KEY, 26)) {
-        return false;
-    }
-
-    if (!hash_update(&inner_hash_writer, message_bytes, message_byte_len)) {
-        return false;
-    }
+    hash_writer_t inner_hash_writer;
 
-    return hash_finalize(&inner_hash_writer, out_hash, out_len);
+    return personal_message_hash_init(&inner_hash_writer) &&
+           personal_message_hash_update(&inner_hash_writer, message_bytes, message_byte_len) &&
+           personal_message_hash_finalize(&inner_hash_writer, out_hash, out_len);
 }
@@ -23,10 +23,45 @@
  *****************************************************************************/
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "./hash.h"
+
+/**
+ * Hash a personal message sent in a single APDU.
+ *
+ * @return true if success, false otherwise.
+ */
 bool hash_personal_message(uint8_t* message_bytes,
                            size_t message_byte_len,
                            uint8_t* out_hash,
                            size_t out_len);
+
+/**
+ * Start the hash of a personal message sent in chunks. The chunks are
+ * written as they arrive so the message is never kept whole in RAM.
+ *
+ * @param[out] hash
+ *   The hash writer of the message
+ *
+ * @return true if success, false otherwise.
+ */
+bool personal_message_hash_init(hash_writer_t* hash);
+
+/**
+ * Write the next chunk of a personal message, chunks must not be empty.
+ *
+ * @return true if success, false otherwise.
+ */
+bool personal_message_hash_update(hash_writer_t* hash, const uint8_t* chunk, size_t chunk_len);
+
+/**
+ * Write the hash of the personal message to out_hash, once every chunk
+ * was written. The result is the same as hash_personal_message over the
+ * whole message.
+ *
+ * @return true if success, false otherwise.
+ */
+bool personal_message_hash_finalize(hash_writer_t* hash, uint8_t* out_hash, size_t out_len);
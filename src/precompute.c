@@ -0,0 +1,106 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <string.h>   // explicit_bzero
+
+#include "./precompute.h"
+#include "./globals.h"
+#include "./crypto.h"
+#include "./sighash.h"
+
+static void push(precompute_queue_t *queue, precompute_task_e task) {
+    if (queue->head + queue->len < PRECOMPUTE_QUEUE_LEN) {
+        queue->tasks[queue->head + queue->len] = (uint8_t) task;
+        queue->len++;
+    }
+}
+
+static bool run(precompute_task_e task) {
+    transaction_ctx_t *tx_info = &G_context.tx_info;
+
+    switch (task) {
+        case PRECOMPUTE_SIGHASH_DIGESTS:
+            return sighash_cache_finish(&tx_info->transaction, &tx_info->sighash_cache);
+        case PRECOMPUTE_ACCOUNT_NODE:
+            return crypto_prepare_account_node() == 0;
+        case PRECOMPUTE_ADDRESS_NODE:
+            return crypto_prepare_address_node(
+                       &tx_info->transaction.tx_inputs[tx_info->signing_order[0]]) == 0;
+        default:
+            return false;
+    }
+}
+
+void precompute_start(void) {
+    precompute_queue_t *queue = &G_context.tx_info.precompute;
+
+    explicit_bzero(queue, sizeof(*queue));
+
+    push(queue, PRECOMPUTE_SIGHASH_DIGESTS);
+    push(queue, PRECOMPUTE_ACCOUNT_NODE);
+    if (!G_context.tx_info.streamed) {
+        // Streamed inputs are signed in the order the host chooses
+        push(queue, PRECOMPUTE_ADDRESS_NODE);
+    }
+}
+
+static bool run_next(precompute_queue_t *queue) {
+    if (!run((precompute_task_e) queue->tasks[queue->head])) {
+        // Stop here, precompute_finish reports it
+        queue->failed = true;
+        return false;
+    }
+
+    queue->head++;
+    queue->len--;
+
+    return true;
+}
+
+void precompute_step(void) {
+    precompute_queue_t *queue = &G_context.tx_info.precompute;
+
+    if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_PARSED ||
+        queue->len == 0 || queue->failed) {
+        return;
+    }
+
+    run_next(queue);
+}
+
+bool precompute_finish(void) {
+    precompute_queue_t *queue = &G_context.tx_info.precompute;
+
+    while (queue->len > 0 && !queue->failed) {
+        run_next(queue);
+    }
+
+    return !queue->failed;
+}
+
+void precompute_discard(void) {
+    explicit_bzero(&G_context.tx_info.precompute, sizeof(G_context.tx_info.precompute));
+    crypto_wipe_derived_keys();
+}
@@ -0,0 +1,61 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#pragma once
+
+#include <stdbool.h>  // bool
+
+/**
+ * Work that doesn't need the user's approval and is done while the
+ * transaction is being reviewed, one task per UI ticker event.
+ */
+typedef enum {
+    PRECOMPUTE_SIGHASH_DIGESTS,  /// finish the digests shared by every input's sighash
+    PRECOMPUTE_ACCOUNT_NODE,     /// derive 44'/111111'/account'
+    PRECOMPUTE_ADDRESS_NODE      /// derive the key of the first input to sign
+} precompute_task_e;
+
+/**
+ * Queue the tasks for the transaction in G_context.tx_info, called when
+ * its review starts.
+ */
+void precompute_start(void);
+
+/**
+ * Run the next queued task, if any. Called from the UI ticker event so
+ * the device works while it waits for the user.
+ */
+void precompute_step(void);
+
+/**
+ * Run every task still queued, called once the user approved.
+ *
+ * @return true if every task succeeded, false otherwise.
+ */
+bool precompute_finish(void);
+
+/**
+ * Drop the queued tasks and wipe what they derived, called when the user
+ * rejects the transaction.
+ */
+void precompute_discard(void);
@@ -0,0 +1,107 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+#include <string.h>   // memcmp, memmove, explicit_bzero
+
+#include "pubkey_cache.h"
+
+typedef struct {
+    uint32_t bip32_path[KASPA_MAX_BIP32_PATH_LEN];  /// BIP32 path
+    uint8_t bip32_path_len;                         /// length of BIP32 path, 0 if free
+    uint32_t last_used;                             /// value of uses when last looked up
+    pubkey_ctx_t pk_info;                           /// public key and chain code of the path
+} pubkey_cache_entry_t;
+
+typedef struct {
+    pubkey_cache_entry_t entries[PUBKEY_CACHE_LEN];
+    uint32_t uses;    /// lookups and insertions so far, orders the entries
+    uint32_t hits;    /// lookups found in the cache
+    uint32_t misses;  /// lookups not found in the cache
+} pubkey_cache_t;
+
+static pubkey_cache_t cache;
+
+static bool entry_matches(const pubkey_cache_entry_t *entry,
+                          const uint32_t *bip32_path,
+                          uint8_t bip32_path_len) {
+    return entry->bip32_path_len != 0 && entry->bip32_path_len == bip32_path_len &&
+           memcmp(entry->bip32_path, bip32_path, bip32_path_len * sizeof(uint32_t)) == 0;
+}
+
+bool pubkey_cache_get(const uint32_t *bip32_path, uint8_t bip32_path_len, pubkey_ctx_t *pk_info) {
+    for (size_t i = 0; i < PUBKEY_CACHE_LEN; i++) {
+        pubkey_cache_entry_t *entry = &cache.entries[i];
+
+        if (entry_matches(entry, bip32_path, bip32_path_len)) {
+            entry->last_used = ++cache.uses;
+            memmove(pk_info, &entry->pk_info, sizeof(*pk_info));
+            cache.hits++;
+            return true;
+        }
+    }
+
+    cache.misses++;
+    return false;
+}
+
+void pubkey_cache_put(const uint32_t *bip32_path,
+                      uint8_t bip32_path_len,
+                      const pubkey_ctx_t *pk_info) {
+    pubkey_cache_entry_t *victim = &cache.entries[0];
+
+    if (bip32_path_len == 0 || bip32_path_len > KASPA_MAX_BIP32_PATH_LEN) {
+        return;
+    }
+
+    // Free entries have last_used = 0 so they go first
+    for (size_t i = 0; i < PUBKEY_CACHE_LEN; i++) {
+        pubkey_cache_entry_t *entry = &cache.entries[i];
+
+        if (entry_matches(entry, bip32_path, bip32_path_len)) {
+            victim = entry;
+            break;
+        }
+        if (entry->last_used < victim->last_used) {
+            victim = entry;
+        }
+    }
+
+    memmove(victim->bip32_path, bip32_path, bip32_path_len * sizeof(uint32_t));
+    victim->bip32_path_len = bip32_path_len;
+    victim->last_used = ++cache.uses;
+    memmove(&victim->pk_info, pk_info, sizeof(victim->pk_info));
+}
+
+void pubkey_cache_clear() {
+    explicit_bzero(&cache, sizeof(cache));
+}
+
+uint32_t pubkey_cache_hits() {
+    return cache.hits;
+}
+
+uint32_t pubkey_cache_misses() {
+    return cache.misses;
+}
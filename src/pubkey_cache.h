@@ -0,0 +1,85 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#pragma once
+
+#include <stdint.h>   // uint*_t
+#include <stdbool.h>  // bool
+
+#include "types.h"
+
+/**
+ * Number of public keys kept by the cache, enough for the receive and
+ * change addresses a wallet keeps asking for.
+ */
+#define PUBKEY_CACHE_LEN 4
+
+/**
+ * Look for the public key of a BIP32 path in the cache. On a hit the
+ * entry becomes the most recently used one.
+ *
+ * @param[in]  bip32_path
+ *   Pointer to buffer with BIP32 path.
+ * @param[in]  bip32_path_len
+ *   Number of path in BIP32 path.
+ * @param[out] pk_info
+ *   Public key and chain code of the path, written on a hit only.
+ *
+ * @return true if the path was in the cache, false otherwise.
+ *
+ */
+bool pubkey_cache_get(const uint32_t *bip32_path, uint8_t bip32_path_len, pubkey_ctx_t *pk_info);
+
+/**
+ * Add the public key of a BIP32 path to the cache, in place of the least
+ * recently used entry if it is full.
+ *
+ * @param[in] bip32_path
+ *   Pointer to buffer with BIP32 path.
+ * @param[in] bip32_path_len
+ *   Number of path in BIP32 path, at most KASPA_MAX_BIP32_PATH_LEN.
+ * @param[in] pk_info
+ *   Public key and chain code of the path.
+ *
+ */
+void pubkey_cache_put(const uint32_t *bip32_path,
+                      uint8_t bip32_path_len,
+                      const pubkey_ctx_t *pk_info);
+
+/**
+ * Wipe every entry of the cache and its counters.
+ *
+ */
+void pubkey_cache_clear(void);
+
+/**
+ * Number of lookups answered from the cache since it was last cleared.
+ *
+ */
+uint32_t pubkey_cache_hits(void);
+
+/**
+ * Number of lookups that had to derive the key since it was last cleared.
+ *
+ */
+uint32_t pubkey_cache_misses(void);
@@ -25,302 +25,236 @@
 #include <string.h>
 #include <stdbool.h>
 
-#include "./import/blake2-impl.h"
-#include "./import/blake2b.h"
-
 #include "./transaction/types.h"
+#include "./sighash.h"
+#include "./hash.h"
 #include "buffer.h"
-#include "write.h"
 #include "globals.h"
 #include "./constants.h"
 
-static bool hash_init(blake2b_state* hash, size_t size, uint8_t* key, size_t key_len) {
-    if (key == NULL && key_len != 0) {
-        goto err;
-    }
-
-    if (size % 8 != 0 || size < 8 || size > 512) {
-        goto err;
-    }
-    memset(hash, 0, sizeof(blake2b_state));
-
-    size = size / 8;
-
-    if (blake2b_init_key(hash, size, key, key_len) < 0) {
-        goto err;
-    }
-    return true;
-
-err:
-    return false;
-}
-
-static bool hash_update(blake2b_state* hash, uint8_t* data, size_t len) {
-    // blake2b_update currently always returns 0
-    return blake2b_update(hash, data, len) == 0;
-}
-
-static bool hash_finalize(blake2b_state* hash, uint8_t* out, size_t out_len) {
-    if (out_len < 32) {
-        return false;
-    }
-    // blake2b_final returns 0 for success and -1 for any error
-    return blake2b_final(hash, out, 32) == 0;
-}
-
-static bool calc_prev_outputs_hash(transaction_t* tx, uint8_t* out_hash, size_t out_len) {
-    blake2b_state inner_hash_writer;
-    uint8_t inner_buffer[32] = {0};
-    if (!hash_init(&inner_hash_writer, 256, (uint8_t*) SIGNING_KEY, 22)) {
+static bool calc_sequences_hash(hash_writer_t* writer,
+                                size_t input_len,
+                                uint8_t* out_hash,
+                                size_t out_len) {
+    if (!hash_init(writer, TX_SIGNING_HASH)) {
         return false;
     }
 
-    for (size_t i = 0; i < tx->tx_input_len; i++) {
-        memset(inner_buffer, 0, sizeof(inner_buffer));
-        write_u32_le(inner_buffer, 0, tx->tx_inputs[i].index);
-        if (!hash_update(&inner_hash_writer, tx->tx_inputs[i].tx_id, 32)) {
-            return false;
-        }
-        if (!hash_update(&inner_hash_writer, inner_buffer, 4)) {
-            return false;
-        }
-    }
-
-    return hash_finalize(&inner_hash_writer, out_hash, out_len);
-}
-
-static bool calc_sequences_hash(transaction_t* tx, uint8_t* out_hash, size_t out_len) {
-    blake2b_state inner_hash_writer;
-    uint8_t inner_buffer[32] = {0};
-    if (!hash_init(&inner_hash_writer, 256, (uint8_t*) SIGNING_KEY, 22)) {
+    // Sequence of every input, little endian, 8 bytes
+    // The sequence is not sent by the host, it is always 0
+    if (!hash_write_zeros(writer, 8 * input_len)) {
         return false;
     }
 
-    for (size_t i = 0; i < tx->tx_input_len; i++) {
-        memset(inner_buffer, 0, sizeof(inner_buffer));
-        write_u64_le(inner_buffer, 0, tx->tx_inputs[i].sequence);
-        if (!hash_update(&inner_hash_writer, inner_buffer, 8)) {
-            return false;
-        }
-        memset(inner_buffer, 0, sizeof(inner_buffer));
-    }
-
-    return hash_finalize(&inner_hash_writer, out_hash, out_len);
+    return hash_finalize(writer, out_hash, out_len);
 }
 
-static bool calc_sig_op_count_hash(transaction_t* tx, uint8_t* out_hash, size_t out_len) {
-    blake2b_state inner_hash_writer;
-    uint8_t inner_buffer[32] = {0};
-    if (!hash_init(&inner_hash_writer, 256, (uint8_t*) SIGNING_KEY, 22)) {
+static bool calc_sig_op_count_hash(hash_writer_t* writer,
+                                   size_t input_len,
+                                   uint8_t* out_hash,
+                                   size_t out_len) {
+    if (!hash_init(writer, TX_SIGNING_HASH)) {
         return false;
     }
 
-    for (size_t i = 0; i < tx->tx_input_len; i++) {
-        memset(inner_buffer, 1, 1);
-        if (!hash_update(&inner_hash_writer, inner_buffer, 1)) {
+    // Every input has a sig op count of 1
+    for (size_t i = 0; i < input_len; i++) {
+        if (!hash_write_u8(writer, 0x01)) {
             return false;
         }
-        memset(inner_buffer, 0, sizeof(inner_buffer));
     }
 
-    return hash_finalize(&inner_hash_writer, out_hash, out_len);
+    return hash_finalize(writer, out_hash, out_len);
 }
 
-static bool calc_outputs_hash(transaction_t* tx, uint8_t* out_hash, size_t out_len) {
-    blake2b_state inner_hash_writer;
-    uint8_t inner_buffer[32] = {0};
-    if (!hash_init(&inner_hash_writer, 256, (uint8_t*) SIGNING_KEY, 22)) {
+static bool calc_outputs_hash(hash_writer_t* writer,
+                              transaction_t* tx,
+                              uint8_t* out_hash,
+                              size_t out_len) {
+    if (!hash_init(writer, TX_SIGNING_HASH)) {
         return false;
     }
 
     for (size_t i = 0; i < tx->tx_output_len; i++) {
-        memset(inner_buffer, 0, sizeof(inner_buffer));
-
-        write_u64_le(inner_buffer, 0, tx->tx_outputs[i].value);
-        if (!hash_update(&inner_hash_writer, inner_buffer, 8)) {
+        if (!hash_write_u64_le(writer, tx->tx_output_values[i])) {
             // Write the output value
             return false;
         }
-        memset(inner_buffer, 0, sizeof(inner_buffer));
 
-        if (!hash_update(&inner_hash_writer, inner_buffer, 2)) {
+        if (!hash_write_u16_le(writer, 0)) {
             // Write the output script version, assume 0
             return false;
         }
 
-        uint8_t script_len = 0;
-        if (tx->tx_outputs[i].script_public_key[0] == 0xaa) {
-            // P2SH script public key is always 35 bytes,
-            // always begins with 0xaa and ends with 0x87
-            script_len = 35;
-            write_u64_le(inner_buffer, 0, 35);
-        } else {
-            // First byte is always the length of the following public key
-            // Last byte is always 0xac (op code for normal transactions)
-            script_len = tx->tx_outputs[i].script_public_key[0] + 2;
-            write_u64_le(inner_buffer,
-                         0,
-                         script_len);  // Write the number of bytes of the script public key
-        }
-
-        if (!hash_update(&inner_hash_writer, inner_buffer, 8)) {
+        // Write the number of bytes of the script public key
+        if (!hash_write_u64_le(writer, tx->tx_output_script_lens[i])) {
             return false;
         }
-        if (!hash_update(&inner_hash_writer, tx->tx_outputs[i].script_public_key, script_len)) {
+
+        if (!hash_update(writer,
+                         tx->tx_scripts.data + tx->tx_output_script_offsets[i],
+                         tx->tx_output_script_lens[i])) {
             return false;
         }
     }
 
-    return hash_finalize(&inner_hash_writer, out_hash, out_len);
-}
-
-static bool calc_txin_script_public_key(uint8_t* public_key, uint8_t* out_hash, size_t out_len) {
-    if (out_len < 34) {
-        return false;
-    }
-    // Assume schnorr
-    out_hash[0] = 0x20;
-    memmove(out_hash + 1, public_key, 32);
-    out_hash[33] = OP_CHECKSIG;
-
-    return true;
+    return hash_finalize(writer, out_hash, out_len);
 }
 
-bool calc_sighash(transaction_t* tx,
-                  transaction_input_t* txin,
-                  uint8_t* public_key,
-                  uint8_t* out_hash,
-                  size_t out_len) {
-    if (out_len < 32) {
-        return false;
-    }
-    uint8_t outer_buffer[36] = {0};
-    blake2b_state sighash;
-
-    memset(outer_buffer, 0, sizeof(outer_buffer));
+static bool calc_sighash_prefix(transaction_t* tx, sighash_cache_t* cache) {
+    hash_writer_t* sighash = &cache->writer;
 
-    if (!hash_init(&sighash, 256, (uint8_t*) SIGNING_KEY, 22)) {
+    if (!hash_init(sighash, TX_SIGNING_HASH)) {
         return false;
     }
 
     // Write version, little endian, 2 bytes
-    write_u16_le(outer_buffer, 0, tx->version);
-    if (!hash_update(&sighash, outer_buffer, 2)) {
+    if (!hash_write_u16_le(sighash, tx->version)) {
         return false;
     }
-    memset(outer_buffer, 0, sizeof(outer_buffer));
 
     // Write previous outputs hash
-    if (!calc_prev_outputs_hash(tx, outer_buffer, sizeof(outer_buffer))) {
-        return false;
-    }
-    if (!hash_update(&sighash, outer_buffer, 32)) {
+    if (!hash_update(sighash, cache->prev_outputs_hash, 32)) {
         return false;
     }
-    memset(outer_buffer, 0, sizeof(outer_buffer));
 
     // Write sequence hash
-    if (!calc_sequences_hash(tx, outer_buffer, sizeof(outer_buffer))) {
-        return false;
-    }
-    if (!hash_update(&sighash, outer_buffer, 32)) {
+    if (!hash_update(sighash, cache->sequences_hash, 32)) {
         return false;
     }
-    memset(outer_buffer, 0, sizeof(outer_buffer));
 
     // Write sig op count hash
-    if (!calc_sig_op_count_hash(tx, outer_buffer, sizeof(outer_buffer))) {
+    return hash_update(sighash, cache->sig_op_count_hash, 32);
+}
+
+bool sighash_cache_start(sighash_cache_t* cache) {
+    return hash_init(&cache->writer, TX_SIGNING_HASH);
+}
+
+bool sighash_cache_add_input(sighash_cache_t* cache, const transaction_input_t* txin) {
+    // Previous outpoint: transaction id followed by the index, little endian, 4 bytes
+    return hash_update(&cache->writer, txin->tx_id, 32) &&
+           hash_write_u32_le(&cache->writer, txin->index);
+}
+
+bool sighash_cache_finish(transaction_t* tx, sighash_cache_t* cache) {
+    if (!hash_finalize(&cache->writer,
+                       cache->prev_outputs_hash,
+                       sizeof(cache->prev_outputs_hash))) {
         return false;
     }
-    if (!hash_update(&sighash, outer_buffer, 32)) {
+
+    // The outpoints are done, the writer is reused for each of the other digests
+    if (!calc_sequences_hash(&cache->writer,
+                             tx->tx_input_len,
+                             cache->sequences_hash,
+                             sizeof(cache->sequences_hash))) {
         return false;
     }
-    memset(outer_buffer, 0, sizeof(outer_buffer));
 
-    // Write Hash of the outpoint
-    if (!hash_update(&sighash, txin->tx_id, 32)) {
+    if (!calc_sig_op_count_hash(&cache->writer,
+                                tx->tx_input_len,
+                                cache->sig_op_count_hash,
+                                sizeof(cache->sig_op_count_hash))) {
         return false;
     }
-    write_u32_le(outer_buffer, 0, txin->index);
-    if (!hash_update(&sighash, outer_buffer, 4)) {
+
+    if (!calc_outputs_hash(&cache->writer,
+                           tx,
+                           cache->outputs_hash,
+                           sizeof(cache->outputs_hash))) {
         return false;
     }
-    memset(outer_buffer, 0, sizeof(outer_buffer));
 
-    if (!hash_update(&sighash, outer_buffer, 2)) {
-        // Write input script version, assume 0
+    return calc_sighash_prefix(tx, cache);
+}
+
+bool calc_sighash_cache(transaction_t* tx, sighash_cache_t* cache) {
+    if (!sighash_cache_start(cache)) {
         return false;
     }
 
-    // Write input's script_public_key. Length as uint64_t followed by script
-    // count (1 byte) + public key (32/33 byte) + op (1 byte)
-    uint64_t script_len = 34;
-    write_u64_le(outer_buffer, 0, script_len);
-    if (!hash_update(&sighash, outer_buffer, 8)) {
+    for (size_t i = 0; i < tx->tx_input_len; i++) {
+        if (!sighash_cache_add_input(cache, &tx->tx_inputs[i])) {
+            return false;
+        }
+    }
+
+    return sighash_cache_finish(tx, cache);
+}
+
+bool calc_sighash(sighash_cache_t* cache,
+                  transaction_input_t* txin,
+                  const uint8_t* public_key,
+                  uint8_t* out_hash,
+                  size_t out_len) {
+    if (out_len < 32) {
         return false;
     }
 
-    if (!calc_txin_script_public_key(public_key, outer_buffer, sizeof(outer_buffer))) {
+    // Resume from the snapshot taken after version, previous outputs hash,
+    // sequences hash and sig op count hash were written
+    hash_writer_t sighash = cache->writer;
+
+    // Write the outpoint
+    if (!hash_update(&sighash, txin->tx_id, 32) || !hash_write_u32_le(&sighash, txin->index)) {
         return false;
     }
-    if (!hash_update(&sighash, outer_buffer, script_len)) {
+
+    // Write input script version, assume 0
+    if (!hash_write_u16_le(&sighash, 0)) {
         return false;
     }
-    memset(outer_buffer, 0, sizeof(outer_buffer));
 
-    // Write input's value
-    write_u64_le(outer_buffer, 0, txin->value);
-    if (!hash_update(&sighash, outer_buffer, 8)) {
+    // Write input's script_public_key. Length as uint64_t followed by script
+    // count (1 byte) + public key (32 byte) + op (1 byte). Assume schnorr
+    if (!hash_write_u64_le(&sighash, 34) || !hash_write_u8(&sighash, 0x20) ||
+        !hash_update(&sighash, public_key, 32) || !hash_write_u8(&sighash, OP_CHECKSIG)) {
         return false;
     }
-    memset(outer_buffer, 0, sizeof(outer_buffer));
 
-    // Write input's sequence number
-    write_u64_le(outer_buffer, 0, txin->sequence);
-    if (!hash_update(&sighash, outer_buffer, 8)) {
+    // Write input's value and sequence number, assume 0
+    if (!hash_write_u64_le(&sighash, txin->value) || !hash_write_u64_le(&sighash, 0)) {
         return false;
     }
-    memset(outer_buffer, 0, sizeof(outer_buffer));
 
     // Write sigopcount, assume 1
-    outer_buffer[0] = 0x01;
-    if (!hash_update(&sighash, outer_buffer, 1)) {
+    if (!hash_write_u8(&sighash, 0x01)) {
         return false;
     }
-    memset(outer_buffer, 0, sizeof(outer_buffer));
 
     // Write outputs hash
-    if (!calc_outputs_hash(tx, outer_buffer, sizeof(outer_buffer))) {
-        return false;
-    }
-    if (!hash_update(&sighash, outer_buffer, 32)) {
+    if (!hash_update(&sighash, cache->outputs_hash, 32)) {
         return false;
     }
-    memset(outer_buffer, 0, sizeof(outer_buffer));
 
-    // Write last bits of data, assuming 0
-    if (!hash_update(&sighash, outer_buffer, 8)) {
-        // Write locktime of 0
+    // Write locktime (8), subnetwork id (20), gas (8) and payload hash (32),
+    // all assumed to be zero
+    if (!hash_write_zeros(&sighash, 8 + 20 + 8 + 32)) {
         return false;
     }
-    if (!hash_update(&sighash, outer_buffer, 20)) {
-        // Write subnetwork Id, assume zero hash
-        return false;
-    }
-    if (!hash_update(&sighash, outer_buffer, 8)) {
-        // Write gas, assume 0
+
+    // Write sighash type, assume SigHashAll => 0x01
+    if (!hash_write_u8(&sighash, 0x01)) {
         return false;
     }
-    if (!hash_update(&sighash, outer_buffer, 32)) {
-        // Write payload hash, assume 0
+
+    return hash_finalize(&sighash, out_hash, out_len);
+}
+
+bool calc_sighash_all(transaction_t* tx,
+                      sighash_cache_t* cache,
+                      const uint8_t pubkeys[][32],
+                      uint8_t out[][32]) {
+    if (!calc_sighash_cache(tx, cache)) {
         return false;
     }
 
-    // Write sighash type, assume SigHashAll => 0x01
-    outer_buffer[0] = 0x01;
-    if (!hash_update(&sighash, outer_buffer, 1)) {
-        return false;
+    for (size_t i = 0; i < tx->tx_input_len; i++) {
+        if (!calc_sighash(cache, &tx->tx_inputs[i], pubkeys[i], out[i], sizeof(out[i]))) {
+            return false;
+        }
     }
 
-    return hash_finalize(&sighash, out_hash, out_len);
+    return true;
 }
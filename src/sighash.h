@@ -24,13 +24,104 @@
 #pragma once
 
 #include <stdint.h>
+#include "./hash.h"
 #include "./transaction/types.h"
 
+/**
+ * Transaction-wide digests that are part of every input's sighash.
+ * These only depend on the transaction so they are computed once and
+ * reused for each input being signed.
+ *
+ * Only the outpoints need a running writer: inputs may not be stored
+ * (see P1_START_STREAMED), while the sequences and sig op counts only
+ * depend on the input count and the outputs are kept in the transaction.
+ * Those are hashed one after the other by sighash_cache_finish, with the
+ * same writer.
+ *
+ * Every sighash preimage also starts with the same bytes (version and
+ * the first three digests). Once the digests are done, writer holds the
+ * sighash writer with those already absorbed, so each input starts from
+ * a copy of it.
+ */
+typedef struct {
+    uint8_t prev_outputs_hash[32];  /// hash of all the inputs' outpoints
+    uint8_t sequences_hash[32];     /// hash of all the inputs' sequences
+    uint8_t sig_op_count_hash[32];  /// hash of all the inputs' sig op counts
+    uint8_t outputs_hash[32];       /// hash of all the outputs
+    hash_writer_t writer;           /// outpoints until sighash_cache_finish, then the prefix
+} sighash_cache_t;
+
+/**
+ * Start the running writer of the transaction-wide digests
+ *
+ * @param[out] cache
+ *   The cache to initialize
+ *
+ * @return true if success, false otherwise.
+ */
+bool sighash_cache_start(sighash_cache_t* cache);
+
+/**
+ * Write a parsed input to the running writer.
+ * Inputs must be added in transaction order.
+ *
+ * @return true if success, false otherwise.
+ */
+bool sighash_cache_add_input(sighash_cache_t* cache, const transaction_input_t* txin);
+
+/**
+ * Finish the transaction-wide digests once every input was added
+ *
+ * @param[in]     tx
+ *   The transaction header and its outputs (the inputs are not used)
+ * @param[in,out] cache
+ *   The cache the inputs were added to
+ *
+ * @return true if all the digests were computed, false otherwise.
+ */
+bool sighash_cache_finish(transaction_t* tx, sighash_cache_t* cache);
+
+/**
+ * Calculate the transaction-wide digests used by calc_sighash
+ * from an already parsed transaction
+ *
+ * @param[in]  tx
+ *   The fully parsed transaction
+ * @param[out] cache
+ *   Where the digests will be written
+ *
+ * @return true if all the digests were computed, false otherwise.
+ */
+bool calc_sighash_cache(transaction_t* tx, sighash_cache_t* cache);
+
 /**
  * Calculate the signature hash for the given transaction and input
+ *
+ * @param[in]  cache
+ *   Digests computed by calc_sighash_cache for the same transaction
  */
-bool calc_sighash(transaction_t* tx,
+bool calc_sighash(sighash_cache_t* cache,
                   transaction_input_t* txin,
-                  uint8_t* public_key,
+                  const uint8_t* public_key,
                   uint8_t* out_hash,
                   size_t out_len);
+
+/**
+ * Calculate the signature hashes of every input of the transaction.
+ * The transaction-wide digests are computed once and shared by all inputs.
+ *
+ * @param[in]  tx
+ *   The fully parsed transaction
+ * @param[out] cache
+ *   Where the digests will be written, as by calc_sighash_cache
+ * @param[in]  pubkeys
+ *   The public key of each input, tx_input_len entries
+ * @param[out] out
+ *   Where the sighash of each input is written, tx_input_len entries
+ *
+ * @return true if every sighash was computed, false otherwise.
+ */
+bool calc_sighash_all(transaction_t* tx,
+                      sighash_cache_t* cache,
+                      const uint8_t pubkeys[][32],
+                      uint8_t out[][32]);
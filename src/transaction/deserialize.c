@@ -26,8 +26,31 @@
 #include "utils.h"
 #include "types.h"
 #include "buffer.h"
+#include "read.h"
+
+static bool script_arena_append(script_arena_t *scripts,
+                                const uint8_t *script,
+                                size_t script_len,
+                                uint16_t *offset) {
+    if (script_len > sizeof(scripts->data) - scripts->len) {
+        return false;
+    }
+
+    memcpy(scripts->data + scripts->len, script, script_len);
+    *offset = scripts->len;
+    scripts->len += script_len;
+
+    // len may be rolled back later, this is what context_reset has to wipe
+    if (scripts->len > scripts->high_water) {
+        scripts->high_water = scripts->len;
+    }
+
+    return true;
+}
 
-parser_status_e transaction_output_deserialize(buffer_t *buf, transaction_output_t *txout) {
+parser_status_e transaction_output_deserialize(buffer_t *buf,
+                                               transaction_output_t *txout,
+                                               script_arena_t *scripts) {
     // 8 bytes
     if (!buffer_read_u64(buf, &txout->value, BE)) {
         return OUTPUT_VALUE_PARSING_ERROR;
@@ -37,9 +60,10 @@ parser_status_e transaction_output_deserialize(buffer_t *buf, transaction_output
         return OUTPUT_SCRIPT_PUBKEY_PARSING_ERROR;
     }
 
-    uint8_t script_len = (uint8_t) * (buf->ptr + buf->offset);
+    const uint8_t *script = buf->ptr + buf->offset;
+    size_t script_len = 0;
 
-    if (script_len == OP_BLAKE2B) {
+    if (script[0] == OP_BLAKE2B) {
         // P2SH = 0xaa + 0x20 + (script hash) + 0x87
         // Total length = 35
         // script len is actually the second byte if the first one is 0xaa
@@ -47,54 +71,58 @@ parser_status_e transaction_output_deserialize(buffer_t *buf, transaction_output
             return OUTPUT_SCRIPT_PUBKEY_PARSING_ERROR;
         }
 
-        script_len = (uint8_t) * (buf->ptr + buf->offset + 1);
-
         // For P2SH, we expect len to always be 0x20
-        if (script_len != 0x20) {
+        if (script[1] != 0x20) {
             return OUTPUT_SCRIPT_PUBKEY_PARSING_ERROR;
         }
 
-        if (!buffer_can_read(buf, script_len + 3)) {
-            return OUTPUT_SCRIPT_PUBKEY_PARSING_ERROR;
-        }
+        script_len = script[1] + 3;
 
-        uint8_t sig_op_code = *(buf->ptr + buf->offset + script_len + 2);
-
-        // We expect the end to always be 0x87 for P2SH
-        if (sig_op_code != OP_EQUAL) {
+        if (!buffer_can_read(buf, script_len)) {
             return OUTPUT_SCRIPT_PUBKEY_PARSING_ERROR;
         }
 
-        memcpy(txout->script_public_key, buf->ptr + buf->offset, script_len + 3);
-
-        if (!buffer_seek_cur(buf, script_len + 3)) {
+        // We expect the end to always be 0x87 for P2SH
+        if (script[script_len - 1] != OP_EQUAL) {
             return OUTPUT_SCRIPT_PUBKEY_PARSING_ERROR;
         }
-    } else if (script_len == 0x20 || script_len == 0x21) {
+    } else if (script[0] == 0x20 || script[0] == 0x21) {
         // P2PK
         // Can only be length 32 or 33. Fail it otherwise:
-        if (!buffer_can_read(buf, script_len + 2)) {
-            return OUTPUT_SCRIPT_PUBKEY_PARSING_ERROR;
-        }
-
-        uint8_t sig_op_code = *(buf->ptr + buf->offset + script_len + 1);
+        script_len = script[0] + 2;
 
-        if ((script_len == 0x20 && sig_op_code != OP_CHECKSIG) ||
-            (script_len == 0x21 && sig_op_code != OP_CHECKSIGECDSA)) {
+        if (!buffer_can_read(buf, script_len)) {
             return OUTPUT_SCRIPT_PUBKEY_PARSING_ERROR;
         }
 
-        memcpy(txout->script_public_key, buf->ptr + buf->offset, script_len + 2);
+        uint8_t sig_op_code = script[script_len - 1];
 
-        if (!buffer_seek_cur(buf, script_len + 2)) {
+        if ((script[0] == 0x20 && sig_op_code != OP_CHECKSIG) ||
+            (script[0] == 0x21 && sig_op_code != OP_CHECKSIGECDSA)) {
             return OUTPUT_SCRIPT_PUBKEY_PARSING_ERROR;
         }
     } else {
         return OUTPUT_SCRIPT_PUBKEY_PARSING_ERROR;
     }
 
-    // Total: 8 + 32|33 = 40|41 bytes
-    return buf->size - buf->offset == 0 ? PARSING_OK : OUTPUT_PARSING_ERROR;
+    // Total: 8 + 34|35 = 42|43 bytes
+    // Checked before the script is copied so that a rejected output leaves
+    // nothing behind in the arena
+    if (buf->size - buf->offset != script_len) {
+        return OUTPUT_PARSING_ERROR;
+    }
+
+    if (!script_arena_append(scripts, script, script_len, &txout->script_offset)) {
+        return OUTPUT_SCRIPT_PUBKEY_PARSING_ERROR;
+    }
+
+    txout->script_len = (uint8_t) script_len;
+
+    if (!buffer_seek_cur(buf, script_len)) {
+        return OUTPUT_SCRIPT_PUBKEY_PARSING_ERROR;
+    }
+
+    return PARSING_OK;
 }
 
 parser_status_e transaction_input_deserialize(buffer_t *buf, transaction_input_t *txin) {
@@ -134,13 +162,32 @@ parser_status_e transaction_input_deserialize(buffer_t *buf, transaction_input_t
     return buf->size - buf->offset == 0 ? PARSING_OK : INPUT_PARSING_ERROR;
 }
 
-parser_status_e transaction_deserialize(buffer_t *buf, transaction_t *tx, uint32_t *bip32_path) {
+parser_status_e transaction_input_deserialize_record(const uint8_t *record,
+                                                     size_t record_len,
+                                                     transaction_input_t *txin) {
+    // Every field has a fixed size, this one check covers all of them
+    if (record_len != SERIALIZED_INPUT_LEN) {
+        return INPUT_PARSING_ERROR;
+    }
+
+    txin->value = read_u64_be(record, 0);
+    memcpy(txin->tx_id, record + 8, 32);
+    txin->address_type = record[40];
+    txin->address_index = read_u32_be(record, 41);
+    txin->index = record[45];
+
+    return PARSING_OK;
+}
+
+static parser_status_e deserialize_header(buffer_t *buf,
+                                          transaction_t *tx,
+                                          uint32_t *bip32_path,
+                                          bool streamed) {
     if (KASPA_MAX_BIP32_PATH_LEN < 5) {
         return HEADER_PARSING_ERROR;
     }
 
     uint8_t n_output = 0;
-    uint8_t n_input = 0;
     uint8_t change_address_type = 0;
     uint32_t change_address_index = 0;
 
@@ -155,20 +202,35 @@ parser_status_e transaction_deserialize(buffer_t *buf, transaction_t *tx, uint32
 
     tx->tx_output_len = n_output;
 
-    // Must be 1 or 2 outputs, must match the number of outputs we parsed
-    if (tx->tx_output_len < 1 || tx->tx_output_len > 2) {
+    // Must be at least 1, must match the number of outputs we parsed
+    if (tx->tx_output_len < 1 || tx->tx_output_len > MAX_OUTPUT_COUNT) {
         return OUTPUTS_LENGTH_PARSING_ERROR;
     }
 
-    if (!buffer_read_u8(buf, &n_input)) {
-        return INPUTS_LENGTH_PARSING_ERROR;
-    }
+    if (streamed) {
+        // Streamed inputs are not stored, only whether they were signed
+        uint16_t n_input = 0;
+        if (!buffer_read_u16(buf, &n_input, BE)) {
+            return INPUTS_LENGTH_PARSING_ERROR;
+        }
 
-    tx->tx_input_len = n_input;
+        tx->tx_input_len = n_input;
 
-    // Must be at least 1, must match the number of inputs we parsed
-    if (tx->tx_input_len < 1 || tx->tx_input_len > MAX_INPUT_COUNT) {
-        return INPUTS_LENGTH_PARSING_ERROR;
+        if (tx->tx_input_len < 1 || tx->tx_input_len > MAX_STREAMED_INPUT_COUNT) {
+            return INPUTS_LENGTH_PARSING_ERROR;
+        }
+    } else {
+        uint8_t n_input = 0;
+        if (!buffer_read_u8(buf, &n_input)) {
+            return INPUTS_LENGTH_PARSING_ERROR;
+        }
+
+        tx->tx_input_len = n_input;
+
+        // Must be at least 1, must match the number of inputs we parsed
+        if (tx->tx_input_len < 1 || tx->tx_input_len > MAX_INPUT_COUNT) {
+            return INPUTS_LENGTH_PARSING_ERROR;
+        }
     }
 
     if (!buffer_read_u8(buf, &change_address_type)) {
@@ -200,3 +262,13 @@ parser_status_e transaction_deserialize(buffer_t *buf, transaction_t *tx, uint32
 
     return buf->size - buf->offset == 0 ? PARSING_OK : HEADER_PARSING_ERROR;
 }
+
+parser_status_e transaction_deserialize(buffer_t *buf, transaction_t *tx, uint32_t *bip32_path) {
+    return deserialize_header(buf, tx, bip32_path, false);
+}
+
+parser_status_e transaction_deserialize_streamed(buffer_t *buf,
+                                                 transaction_t *tx,
+                                                 uint32_t *bip32_path) {
+    return deserialize_header(buf, tx, bip32_path, true);
+}
@@ -41,6 +41,50 @@
  */
 parser_status_e transaction_deserialize(buffer_t *buf, transaction_t *tx, uint32_t *bip32_path);
 
-parser_status_e transaction_output_deserialize(buffer_t *buf, transaction_output_t *txout);
+/**
+ * Deserialize the header of a transaction whose inputs are streamed.
+ * Same as transaction_deserialize except the input count is 2 bytes
+ * and is not bound by MAX_INPUT_COUNT.
+ *
+ * @return PARSING_OK if success, error status otherwise.
+ */
+parser_status_e transaction_deserialize_streamed(buffer_t *buf,
+                                                 transaction_t *tx,
+                                                 uint32_t *bip32_path);
+
+/**
+ * Deserialize a transaction output. Its script is copied to the end of
+ * scripts, txout records where.
+ *
+ * @param[in, out] buf
+ *   Pointer to buffer with the serialized output, nothing else.
+ * @param[out]     txout
+ *   Pointer to the output structure.
+ * @param[in, out] scripts
+ *   Arena the script is appended to, left as is if parsing fails.
+ *
+ * @return PARSING_OK if success, error status otherwise.
+ */
+parser_status_e transaction_output_deserialize(buffer_t *buf,
+                                               transaction_output_t *txout,
+                                               script_arena_t *scripts);
 
 parser_status_e transaction_input_deserialize(buffer_t *buf, transaction_input_t *txin);
+
+/**
+ * Deserialize a transaction input from a record of exactly
+ * SERIALIZED_INPUT_LEN bytes. Same result as transaction_input_deserialize,
+ * but the length is checked once and the fields are read at fixed offsets.
+ *
+ * @param[in]  record
+ *   Pointer to the serialized input, e.g. in the APDU buffer.
+ * @param[in]  record_len
+ *   Length of the record.
+ * @param[out] txin
+ *   Pointer to the input structure, the tx_id is copied there from record.
+ *
+ * @return PARSING_OK if success, INPUT_PARSING_ERROR if the length is wrong.
+ */
+parser_status_e transaction_input_deserialize_record(const uint8_t *record,
+                                                     size_t record_len,
+                                                     transaction_input_t *txin);
@@ -75,29 +75,21 @@ int transaction_input_serialize(const transaction_input_t *txin, uint8_t *out, s
     return (int) offset;
 }
 
-int transaction_output_serialize(const transaction_output_t *txout, uint8_t *out, size_t out_len) {
+int transaction_output_serialize(const transaction_output_t *txout,
+                                 const script_arena_t *scripts,
+                                 uint8_t *out,
+                                 size_t out_len) {
     size_t offset = 0;
 
-    if (out_len < 41) {
+    if (out_len < 8 + (size_t) txout->script_len) {
         return -1;
     }
 
     write_u64_be(out, offset, txout->value);
     offset += 8;
 
-    if (txout->script_public_key[0] == OP_BLAKE2B) {
-        size_t script_len = txout->script_public_key[1];
-
-        memcpy(out + offset, txout->script_public_key, script_len + 3);
-
-        offset += script_len + 3;
-    } else {
-        size_t script_len = txout->script_public_key[0];
-
-        memcpy(out + offset, txout->script_public_key, script_len + 2);
-
-        offset += script_len + 2;
-    }
+    memcpy(out + offset, scripts->data + txout->script_offset, txout->script_len);
+    offset += txout->script_len;
 
     return (int) offset;
 }
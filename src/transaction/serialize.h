@@ -64,8 +64,10 @@ int transaction_input_serialize(const transaction_input_t *txin, uint8_t *out, s
 /**
  * Serialize transaction output in byte buffer.
  *
- * @param[in]  tx
- *   Pointer to input transaction structure.
+ * @param[in]  txout
+ *   Pointer to input transaction output structure.
+ * @param[in]  scripts
+ *   Arena holding the script of the output.
  * @param[out] out
  *   Pointer to output byte buffer.
  * @param[in]  out_len
@@ -74,4 +76,7 @@ int transaction_input_serialize(const transaction_input_t *txin, uint8_t *out, s
  * @return number of bytes written if success, -1 otherwise.
  *
  */
-int transaction_output_serialize(const transaction_output_t *txout, uint8_t *out, size_t out_len);
\ No newline at end of file
+int transaction_output_serialize(const transaction_output_t *txout,
+                                 const script_arena_t *scripts,
+                                 uint8_t *out,
+                                 size_t out_len);
@@ -27,9 +27,11 @@
 #include "../globals.h"
 #include "../crypto.h"
 
-bool tx_validate_parsed_transaction(transaction_t* tx) {
+bool tx_validate_parsed_transaction(transaction_t* tx,
+                                    uint64_t input_total,
+                                    uint64_t output_total) {
     // Invalid output length
-    if (tx->tx_output_len > 2 || tx->tx_output_len < 1) {
+    if (tx->tx_output_len > MAX_OUTPUT_COUNT || tx->tx_output_len < 1) {
         return false;
     }
 
@@ -38,20 +40,19 @@ bool tx_validate_parsed_transaction(transaction_t* tx) {
         return false;
     }
 
-    // Change address will always be output[1] if it exists
-    if (tx->tx_output_len == 2) {
-        transaction_output_t change_output = tx->tx_outputs[1];
+    // Change address will always be the last output if there are 2 or more
+    if (tx->tx_output_len >= 2) {
+        size_t change = tx->tx_output_len - 1;
+        const uint8_t* change_script = tx->tx_scripts.data + tx->tx_output_script_offsets[change];
 
-        if (change_output.script_public_key[0] != 0x20) {
+        if (tx->tx_output_script_lens[change] != 34 || change_script[0] != 0x20) {
             // Change address can only be SCHNORR address and it's not
             return false;
         }
 
         uint8_t change_address_pubkey[32] = {0};
 
-        // We can safely assume script_public_key has exactly 34 bytes. This
-        // was validated when we deserialized the data.
-        memmove(change_address_pubkey, change_output.script_public_key + 1, 32);
+        memmove(change_address_pubkey, change_script + 1, 32);
 
         // Forcing these values. path[3] and path[4]
         // would've been set by transaction_deserialize
@@ -69,17 +70,8 @@ bool tx_validate_parsed_transaction(transaction_t* tx) {
     }
 
     // sum(input.values) >= sum(output.values)
-    uint64_t input_total = 0;
-    uint64_t output_total = 0;
-
-    for (size_t i = 0; i < tx->tx_input_len; i++) {
-        input_total += tx->tx_inputs[i].value;
-    }
-
-    for (size_t o = 0; o < tx->tx_output_len; o++) {
-        output_total += tx->tx_outputs[o].value;
-    }
-
+    // Both sums are accumulated while parsing, inputs may have been
+    // streamed without being stored
     if (input_total < output_total) {
         return false;
     }
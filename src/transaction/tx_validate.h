@@ -28,10 +28,17 @@
 
 /**
  * Check if the transaction as parsed follows the conventions set for it
- * - If a change output exists (output idx 1), the address MUST match the address of the first UTXO
+ * - If a change output exists (the last output when there are 2 or more), the address MUST
+ *   match the change path from the header
  * - Sum of input values must be >= sum of output values
  * @param[in]  tx
  *   The transaction that received the parsed data to validate
+ * @param[in]  input_total
+ *   Sum of the values of all the parsed inputs
+ * @param[in]  output_total
+ *   Sum of the values of all the parsed outputs
  * @return true if the transaction follows conventions, false otherwise.
  */
-bool tx_validate_parsed_transaction(transaction_t* tx);
\ No newline at end of file
+bool tx_validate_parsed_transaction(transaction_t* tx,
+                                    uint64_t input_total,
+                                    uint64_t output_total);
\ No newline at end of file
@@ -66,20 +66,52 @@ typedef enum {
     OP_EQUAL = 0x87           // Used for P2SH (end)
 } op_code_e;
 
+// Fields are ordered by size so that only the padding to the alignment of
+// value is left: 48 bytes for the 46 of a serialized input. The sequence is
+// not sent by the host and is always 0.
 typedef struct {
-    uint8_t address_type;
-    uint32_t address_index;
-    uint64_t sequence;
     uint64_t value;
     uint8_t tx_id[32];
+    uint32_t address_index;
+    uint8_t address_type;
     uint8_t index;
 } transaction_input_t;
 
+/**
+ * Signatures that fit in the area of the inputs, see transaction_t. It caps
+ * the inputs of a transaction signed eagerly, see TX_FLAG_SIGN_EAGERLY.
+ */
+#define MAX_EAGER_SIGNATURE_COUNT \
+    (MAX_INPUT_COUNT * sizeof(transaction_input_t) / MAX_DER_SIG_LEN)
+
+/**
+ * Inputs of a streamed transaction, see P1_START_STREAMED. They are not
+ * stored, so the area of the inputs keeps one bit per input instead, set
+ * once that input is signed.
+ */
+#define MAX_STREAMED_INPUT_COUNT (MAX_INPUT_COUNT * sizeof(transaction_input_t) * 8)
+
+/**
+ * Bytes for the output scripts of a transaction, enough for MAX_OUTPUT_COUNT
+ * of the longest script the parser accepts.
+ */
+#define SCRIPT_ARENA_LEN (MAX_OUTPUT_COUNT * SCRIPT_PUBLIC_KEY_BUFFER_LEN)
+
+/**
+ * Output scripts of a transaction, each one copied right after the previous
+ * one. Outputs refer to their script by offset and length.
+ */
+typedef struct {
+    uint8_t data[SCRIPT_ARENA_LEN];  // scripts in output order
+    uint16_t len;                    // bytes in use
+    uint16_t high_water;             // bytes written since the arena was wiped, see context_reset
+} script_arena_t;
+
 typedef struct {
     uint64_t value;
-    uint8_t script_public_key[SCRIPT_PUBLIC_KEY_BUFFER_LEN];  // In hex: 20 + public_key_hex + ac
-                                                              // (34/35 bytes total)
-} transaction_output_t;
+    uint16_t script_offset;  // offset of the script in its script_arena_t
+    uint8_t script_len;      // length of the script in bytes
+} transaction_output_t;       // an output as parsed, see transaction_t for how it is stored
 
 typedef struct {
     // For signature purposes:
@@ -87,10 +119,22 @@ typedef struct {
     uint16_t version;
     uint32_t account;     // The BIP44 account used for inputs in this transaction
     size_t tx_input_len;  // check
-    size_t tx_output_len;
+    size_t tx_output_len;  // the last one is the change when there are 2 or more
 
-    transaction_output_t tx_outputs[MAX_OUTPUT_COUNT];
-    transaction_input_t tx_inputs[MAX_INPUT_COUNT];  // array of inputs
+    // Outputs are kept as arrays, a transaction_output_t is padded to 16
+    // bytes where its value and script bounds only take 11
+    uint64_t tx_output_values[MAX_OUTPUT_COUNT];
+    uint16_t tx_output_script_offsets[MAX_OUTPUT_COUNT];  // in tx_scripts
+    uint8_t tx_output_script_lens[MAX_OUTPUT_COUNT];
+    script_arena_t tx_scripts;
+    union {
+        transaction_input_t tx_inputs[MAX_INPUT_COUNT];  // array of inputs
+        // Signatures in signing order, overwrites the inputs when they are all
+        // signed at once after approval
+        uint8_t tx_signatures[MAX_EAGER_SIGNATURE_COUNT][MAX_DER_SIG_LEN];
+        // Inputs of a streamed transaction already signed, one bit each
+        uint8_t tx_signed_inputs[MAX_STREAMED_INPUT_COUNT / 8];
+    };
 
     // uint64_t lock_time;      // Don't support this yet
     // uint8_t* subnetwork_id;  // Don't support this yet
@@ -95,19 +95,49 @@ bool script_public_key_to_address(uint8_t* out_address,
     return address_from_pubkey(public_key, type, out_address, address_len);
 }
 
-uint64_t calc_fees(transaction_input_t* inputs,
-                   size_t input_len,
-                   transaction_output_t* outputs,
-                   size_t output_len) {
-    uint64_t fees = 0;
+bool add_to_total(uint64_t* total, uint64_t value) {
+    if (value > UINT64_MAX - *total) {
+        return false;
+    }
+
+    *total += value;
+
+    return true;
+}
+
+uint64_t calc_fees(uint64_t input_total, uint64_t output_total) {
+    // Validation makes sure the inputs cover the outputs
+    return input_total >= output_total ? input_total - output_total : 0;
+}
+
+size_t count_recipient_outputs(const transaction_t* tx) {
+    // With 2 or more outputs the last one is the change
+    return tx->tx_output_len >= 2 ? tx->tx_output_len - 1 : tx->tx_output_len;
+}
+
+void group_inputs_by_path(const transaction_input_t* inputs, size_t input_len, uint8_t* order) {
+    size_t placed = 0;
 
     for (size_t i = 0; i < input_len; i++) {
-        fees += inputs[i].value;
-    }
+        // Already placed with the group of an earlier input
+        bool grouped = false;
+        for (size_t p = 0; p < placed; p++) {
+            if (order[p] == i) {
+                grouped = true;
+                break;
+            }
+        }
+        if (grouped) {
+            continue;
+        }
 
-    for (size_t i = 0; i < output_len; i++) {
-        fees -= outputs[i].value;
-    }
+        order[placed++] = (uint8_t) i;
 
-    return fees;
+        for (size_t j = i + 1; j < input_len; j++) {
+            if (inputs[j].address_type == inputs[i].address_type &&
+                inputs[j].address_index == inputs[i].address_index) {
+                order[placed++] = (uint8_t) j;
+            }
+        }
+    }
 }
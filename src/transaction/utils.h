@@ -56,18 +56,50 @@ void script_public_key_to_address(uint8_t* out_address,
                                   uint8_t* in_script_public_key,
                                   size_t script_len);
 
+/**
+ * Add a value to a running total of values, unless the sum overflows.
+ * @param[in, out] total
+ *   Running total, left as is on overflow.
+ * @param[in] value
+ *   Value of an input or output.
+ *
+ * @return true if success, false if the sum does not fit in 64 bits.
+ */
+bool add_to_total(uint64_t* total, uint64_t value);
+
 /**
  * Calculate the fees by checking the difference between inputs and outputs
- * @param[in] inputs
+ * @param[in] input_total
+ *   Sum of the values of all the inputs.
+ * @param[in] output_total
+ *   Sum of the values of all the outputs.
+ *
+ * @return the fees, 0 if the outputs are worth more than the inputs.
+ */
+uint64_t calc_fees(uint64_t input_total, uint64_t output_total);
+
+/**
+ * Count the outputs shown to the user for review, every output but the
+ * change.
+ *
+ * @param[in] tx
+ *   Parsed transaction.
+ *
+ * @return the number of outputs that pay someone else.
+ */
+size_t count_recipient_outputs(const transaction_t* tx);
+
+/**
+ * Order the inputs so that the ones sharing a derivation path, the same
+ * address_type and address_index, are signed one after the other. Each
+ * key then only has to be derived once. Groups come in the order of
+ * their first input, and inputs keep their order within a group.
+ *
+ * @param[in]  inputs
  *   Pointer to tx input array.
- * @param[in] input_len
- *   Length of tx input byte buffer.
- * @param[in] outputs
- *   Pointer to tx output array.
- * @param[in] output_len
- *   Length of tx output byte buffer.
+ * @param[in]  input_len
+ *   Number of inputs, at most 256.
+ * @param[out] order
+ *   Input indexes in signing order, input_len entries.
  */
-uint64_t calc_fees(transaction_input_t* inputs,
-                   size_t input_len,
-                   transaction_output_t* outputs,
-                   size_t output_len);
+void group_inputs_by_path(const transaction_input_t* inputs, size_t input_len, uint8_t* order);
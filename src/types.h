@@ -28,6 +28,9 @@
 
 #include "constants.h"
 #include "transaction/types.h"
+#include "hash.h"
+#include "sighash.h"
+#include "input_commitment.h"
 #include "bip32.h"
 
 /**
@@ -37,11 +40,13 @@ typedef enum {
 #ifdef HAVE_DEBUG_APDU
     DEBUG_APDU = 0xde,  /// debug test cases
 #endif
-    GET_VERSION = 0x03,     /// version of the application
-    GET_APP_NAME = 0x04,    /// name of the application
-    GET_PUBLIC_KEY = 0x05,  /// public key of corresponding BIP32 path
-    SIGN_TX = 0x06,         /// sign transaction with BIP32 path
-    SIGN_MESSAGE = 0x07     /// sign a personal message with BIP32 path
+    GET_VERSION = 0x03,            /// version of the application
+    GET_APP_NAME = 0x04,           /// name of the application
+    GET_PUBLIC_KEY = 0x05,         /// public key of corresponding BIP32 path
+    SIGN_TX = 0x06,                /// sign transaction with BIP32 path
+    SIGN_MESSAGE = 0x07,           /// sign a personal message with BIP32 path
+    GET_PUBLIC_KEYS = 0x08,        /// public keys of consecutive addresses of an account
+    GET_ACCOUNT_PUBLIC_KEY = 0x09  /// public key and chain code of an account
 } command_e;
 
 /**
@@ -76,29 +81,78 @@ typedef struct {
     uint8_t chain_code[32];      /// for public key derivation
 } pubkey_ctx_t;
 
+/**
+ * Structure for an extended private key, a node of the BIP32 tree.
+ */
+typedef struct {
+    uint8_t private_key[32];  /// private key
+    uint8_t public_key[33];   /// compressed public key, serP(K)
+    uint8_t chain_code[32];   /// for child key derivation
+} bip32_node_t;
+
+/**
+ * Maximum number of tasks waiting in a precompute_queue_t.
+ */
+#define PRECOMPUTE_QUEUE_LEN 4
+
+/**
+ * Queue of the work run in the background while the user reviews a
+ * transaction, see precompute.h.
+ */
+typedef struct {
+    uint8_t tasks[PRECOMPUTE_QUEUE_LEN];  /// precompute_task_e, in run order
+    uint8_t head;                         /// index of the next task to run
+    uint8_t len;                          /// number of tasks waiting
+    bool failed;                          /// a task failed, results can't be used
+} precompute_queue_t;
+
 /**
  * Structure for transaction information context.
  */
 typedef struct {
     transaction_t transaction;           /// structured transaction
+    sighash_cache_t sighash_cache;       /// digests shared by every input's sighash
     uint8_t signature[MAX_DER_SIG_LEN];  /// transaction input signature encoded in DER
-    uint8_t signing_input_index;         /// The input index currently being signed
+    uint16_t signing_input_index;        /// The input index currently being signed
     uint8_t sighash[32];                 /// The sighash being signed
-    uint8_t parsing_input_index;
+    uint16_t parsing_input_index;
     uint8_t parsing_output_index;
+    uint64_t input_total;   /// sum of the values of the parsed inputs, checked for overflow
+    uint64_t output_total;  /// sum of the values of the parsed outputs, checked for overflow
+    bool streamed;          /// inputs are committed to instead of stored, see P1_START_STREAMED
+    uint8_t session_key[INPUT_COMMITMENT_SESSION_LEN];               /// key of the input commitments
+    uint8_t commitments[MAX_INPUTS_PER_APDU][INPUT_COMMITMENT_LEN];  /// of the last P1_INPUTS APDU
+    uint8_t commitments_len;                                         /// inputs in that APDU
+    bool account_node_ready;                 /// account_node holds 44'/111111'/account'
+    bip32_node_t account_node;               /// hardened part of every input's path, derived once
+    bool address_node_ready;                 /// address_node holds the key of the last signed input
+    uint8_t address_node_type;               /// address_type of address_node
+    uint32_t address_node_index;             /// address_index of address_node
+    bip32_node_t address_node;               /// reused by following inputs with the same path
+    uint16_t key_derivations;                /// input keys derived for this transaction
+    uint16_t key_derivations_saved;          /// input keys reused from address_node instead
+    uint16_t signing_position;               /// signatures sent so far
+    uint8_t signing_order[MAX_INPUT_COUNT];  /// input indexes grouped by derivation path
+    bool sign_eagerly;                       /// see TX_FLAG_SIGN_EAGERLY
+    uint16_t inputs_high_water;              /// bytes of the input storage written, see context.h
+    precompute_queue_t precompute;           /// work done while the user reviews
 } transaction_ctx_t;
 
 /**
  * Structure for message signing information context.
  */
 typedef struct {
-    size_t message_len;                  /// message length
-    uint8_t message[128];                /// message bytes
+    size_t message_len;                  /// message length, of the preview if chunked
+    uint8_t message[MAX_MESSAGE_LEN];    /// message bytes, the start of it if chunked
     uint8_t message_hash[32];            /// message hash
     uint8_t signature[MAX_DER_SIG_LEN];  /// signature of the message
     uint32_t account;                    /// The account this message will be signed with
     uint8_t address_type;                /// address type to use for bip32 path
     uint32_t address_index;              /// address index to use for bip32 path
+    bool chunked;                        /// message sent in chunks, see P1_MESSAGE_START_CHUNKED
+    uint16_t message_total_len;          /// length of the whole chunked message
+    uint16_t message_received;           /// chunked message bytes received so far
+    hash_writer_t message_hash_writer;   /// hash of the chunked message received so far
 } message_sign_ctx_t;
 
 /**
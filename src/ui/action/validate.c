@@ -27,6 +27,7 @@
 #include "../menu.h"
 #include "../../sw.h"
 #include "../../crypto.h"
+#include "../../precompute.h"
 #include "../../globals.h"
 #include "../../helper/send_response.h"
 
@@ -40,22 +41,61 @@ void validate_pubkey(bool choice) {
 
 void validate_transaction(bool choice) {
     if (choice) {
+        // Whatever was not done during the review is done now
+        if (!precompute_finish()) {
+            abort_transaction(SW_TX_HASH_FAIL);
+            return;
+        }
+
         G_context.state = STATE_APPROVED;
 
-        int error = crypto_sign_transaction();
+        if (G_context.tx_info.streamed) {
+            // Streamed inputs are signed as the host re-sends them,
+            // it still needs the commitments of the last APDU of inputs
+            io_send_response_pointer(G_context.tx_info.commitments[0],
+                                     G_context.tx_info.commitments_len * INPUT_COMMITMENT_LEN,
+                                     SW_OK);
+            return;
+        }
+
+        if (G_context.tx_info.sign_eagerly) {
+            // Sign everything now, the fetches that follow only copy signatures
+            int error = crypto_sign_transaction_all();
+            if (error != 0) {
+                G_context.state = STATE_NONE;
+                io_send_sw(error);
+            } else {
+                helper_send_response_sig_table();
+            }
+            return;
+        }
+
+        G_context.tx_info.signing_input_index = G_context.tx_info.signing_order[0];
+
+        int error = crypto_sign_transaction(
+            &G_context.tx_info.transaction.tx_inputs[G_context.tx_info.signing_input_index]);
         if (error != 0) {
             G_context.state = STATE_NONE;
+            crypto_wipe_derived_keys();
             io_send_sw(error);
         } else {
             helper_send_response_sig();
-            G_context.tx_info.signing_input_index++;
+            G_context.tx_info.signing_position++;
+            if (G_context.tx_info.signing_position >= G_context.tx_info.transaction.tx_input_len) {
+                crypto_wipe_derived_keys();
+            }
         }
     } else {
-        G_context.state = STATE_NONE;
-        io_send_sw(SW_DENY);
+        abort_transaction(SW_DENY);
     }
 }
 
+int abort_transaction(uint16_t sw) {
+    G_context.state = STATE_NONE;
+    precompute_discard();
+    return io_send_sw(sw);
+}
+
 void validate_message(bool choice) {
     if (choice) {
         G_context.state = STATE_APPROVED;
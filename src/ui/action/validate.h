@@ -24,6 +24,7 @@
 #pragma once
 
 #include <stdbool.h>  // bool
+#include <stdint.h>   // uint16_t
 
 /**
  * Action for public key validation and export.
@@ -43,6 +44,18 @@ void validate_pubkey(bool choice);
  */
 void validate_transaction(bool choice);
 
+/**
+ * End the transaction under review without signing it, the way a reject
+ * does: the precomputed keys are wiped before the status word is sent.
+ *
+ * @param[in] sw
+ *   Status word to send.
+ *
+ * @return the result of io_send_sw.
+ *
+ */
+int abort_transaction(uint16_t sw);
+
 /**
  * Action for message information validation.
  *
@@ -44,13 +44,18 @@
 #include "../common/format_local.h"
 #include "format.h"
 #include "../menu.h"
+#include "../handler/debug.h"
 
 static action_validate_cb g_validate_callback;
 static char g_amount[30];
 static char g_bip32_path[60];
 static char g_address[ECDSA_ADDRESS_LEN + 6];
 static char g_fees[30];
+static char g_output_title[20];
+static size_t g_output_index;
 static char g_message[MAX_MESSAGE_LEN + 6];
+static char g_message_len[20];
+static char g_message_hash[65];
 
 // Validate/Invalidate public key and go back to home
 static void ui_action_validate_pubkey(bool choice) {
@@ -143,6 +148,46 @@ int ui_display_address() {
     return 0;
 }
 
+// Step with icon and text
+UX_STEP_NOCB(ux_display_confirm_account_step,
+             pnn,
+             {
+                 &C_icon_eye,
+                 "Export",
+                 "Account Key",
+             });
+
+// FLOW to export the public key of an account:
+// #1 screen: eye icon + "Export Account Key"
+// #2 screen: display BIP32 Path
+// #3 screen: approve button
+// #4 screen: reject button
+UX_FLOW(ux_display_account_pubkey_flow,
+        &ux_display_confirm_account_step,
+        &ux_display_path_step,
+        &ux_display_approve_step,
+        &ux_display_reject_step);
+
+int ui_display_account_public_key() {
+    if (G_context.req_type != CONFIRM_ADDRESS || G_context.state != STATE_NONE) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    memset(g_bip32_path, 0, sizeof(g_bip32_path));
+    if (!bip32_path_format(G_context.bip32_path,
+                           G_context.bip32_path_len,
+                           g_bip32_path,
+                           sizeof(g_bip32_path))) {
+        return io_send_sw(SW_DISPLAY_BIP32_PATH_FAIL);
+    }
+
+    g_validate_callback = &ui_action_validate_pubkey;
+
+    ux_flow_init(0, ux_display_account_pubkey_flow, NULL);
+    return 0;
+}
+
 // Step with icon and text
 UX_STEP_NOCB(ux_display_review_step,
              pnn,
@@ -181,48 +226,158 @@ UX_FLOW(ux_display_transaction_flow,
         &ux_display_approve_step,
         &ux_display_reject_step);
 
-int ui_display_transaction() {
-    if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_PARSED) {
-        G_context.state = STATE_NONE;
-        return io_send_sw(SW_BAD_STATE);
+// Format the amount and address of an output to g_amount and g_address
+static bool format_output(size_t index) {
+#ifdef HAVE_DEBUG_APDU
+    if (G_debug_fail_next_output_format) {
+        G_debug_fail_next_output_format = false;
+        return false;
     }
+#endif
 
     memset(g_amount, 0, sizeof(g_amount));
     char amount[30] = {0};
     if (!format_fpu64_trimmed(amount,
                               sizeof(amount),
-                              G_context.tx_info.transaction.tx_outputs[0].value,
+                              G_context.tx_info.transaction.tx_output_values[index],
                               EXPONENT_SMALLEST_UNIT)) {
-        return io_send_sw(SW_DISPLAY_AMOUNT_FAIL);
+        return false;
     }
     snprintf(g_amount, sizeof(g_amount), "KAS %.*s", sizeof(amount), amount);
     PRINTF("Amount: %s\n", g_amount);
 
+    memset(g_address, 0, sizeof(g_address));
+
+    uint8_t address[ECDSA_ADDRESS_LEN] = {0};
+
+    transaction_t *tx = &G_context.tx_info.transaction;
+    script_public_key_to_address(address,
+                                 sizeof(address),
+                                 tx->tx_scripts.data + tx->tx_output_script_offsets[index],
+                                 tx->tx_output_script_lens[index]);
+    snprintf(g_address, sizeof(g_address), "%.*s", ECDSA_ADDRESS_LEN, address);
+
+    return true;
+}
+
+static void ui_display_next_output(void);
+
+// Step with title/text for the amount of one of several outputs
+UX_STEP_NOCB(ux_display_output_amount_step,
+             bnnn_paging,
+             {
+                 .title = g_output_title,
+                 .text = g_amount,
+             });
+// Step to go on to the next output
+UX_STEP_CB(ux_display_next_output_step,
+           pb,
+           ui_display_next_output(),
+           {
+               &C_icon_validate_14,
+               "Continue",
+           });
+
+// FLOW to display the first of several outputs:
+// #1 screen : eye icon + "Review Transaction"
+// #2 screen : display address
+// #3 screen : display amount and output number
+// #4 screen : continue button
+// #5 screen : reject button
+UX_FLOW(ux_display_first_output_flow,
+        &ux_display_review_step,
+        &ux_display_address_step,
+        &ux_display_output_amount_step,
+        &ux_display_next_output_step,
+        &ux_display_reject_step);
+
+// FLOW to display the next of several outputs:
+// #1 screen : display address
+// #2 screen : display amount and output number
+// #3 screen : continue button
+// #4 screen : reject button
+UX_FLOW(ux_display_output_flow,
+        &ux_display_address_step,
+        &ux_display_output_amount_step,
+        &ux_display_next_output_step,
+        &ux_display_reject_step);
+
+// FLOW to display the fees once every output was reviewed:
+// #1 screen : display fees
+// #2 screen : approve button
+// #3 screen : reject button
+UX_FLOW(ux_display_outputs_fees_flow,
+        &ux_display_fees_step,
+        &ux_display_approve_step,
+        &ux_display_reject_step);
+
+// Format the output at g_output_index and its title
+static bool format_next_output(void) {
+    if (!format_output(g_output_index)) {
+        return false;
+    }
+
+    snprintf(g_output_title,
+             sizeof(g_output_title),
+             "Amount %u/%u",
+             (unsigned int) (g_output_index + 1),
+             (unsigned int) count_recipient_outputs(&G_context.tx_info.transaction));
+
+    return true;
+}
+
+// Batch payouts are reviewed one output at a time, so that only the
+// strings on screen are kept whatever the number of outputs
+static void ui_display_next_output(void) {
+    g_output_index++;
+
+    if (g_output_index >= count_recipient_outputs(&G_context.tx_info.transaction)) {
+        ux_flow_init(0, ux_display_outputs_fees_flow, NULL);
+        return;
+    }
+
+    if (!format_next_output()) {
+        abort_transaction(SW_DISPLAY_AMOUNT_FAIL);
+        ui_menu_main();
+        return;
+    }
+
+    ux_flow_init(0, ux_display_output_flow, NULL);
+}
+
+int ui_display_transaction() {
+    if (G_context.req_type != CONFIRM_TRANSACTION || G_context.state != STATE_PARSED) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BAD_STATE);
+    }
+
     memset(g_fees, 0, sizeof(g_fees));
     char fees[30] = {0};
     if (!format_fpu64_trimmed(fees,
                               sizeof(fees),
-                              calc_fees(G_context.tx_info.transaction.tx_inputs,
-                                        G_context.tx_info.transaction.tx_input_len,
-                                        G_context.tx_info.transaction.tx_outputs,
-                                        G_context.tx_info.transaction.tx_output_len),
+                              calc_fees(G_context.tx_info.input_total,
+                                        G_context.tx_info.output_total),
                               EXPONENT_SMALLEST_UNIT)) {
-        return io_send_sw(SW_DISPLAY_AMOUNT_FAIL);
+        return abort_transaction(SW_DISPLAY_AMOUNT_FAIL);
     }
     snprintf(g_fees, sizeof(g_fees), "KAS %.*s", sizeof(fees), fees);
 
-    memset(g_address, 0, sizeof(g_address));
+    g_validate_callback = &ui_action_validate_transaction;
+    g_output_index = 0;
 
-    uint8_t address[ECDSA_ADDRESS_LEN] = {0};
+    if (count_recipient_outputs(&G_context.tx_info.transaction) > 1) {
+        if (!format_next_output()) {
+            return abort_transaction(SW_DISPLAY_AMOUNT_FAIL);
+        }
 
-    script_public_key_to_address(
-        address,
-        sizeof(address),
-        G_context.tx_info.transaction.tx_outputs[0].script_public_key,
-        sizeof(G_context.tx_info.transaction.tx_outputs[0].script_public_key));
-    snprintf(g_address, sizeof(g_address), "%.*s", ECDSA_ADDRESS_LEN, address);
+        ux_flow_init(0, ux_display_first_output_flow, NULL);
 
-    g_validate_callback = &ui_action_validate_transaction;
+        return 0;
+    }
+
+    if (!format_output(0)) {
+        return abort_transaction(SW_DISPLAY_AMOUNT_FAIL);
+    }
 
     ux_flow_init(0, ux_display_transaction_flow, NULL);
 
@@ -253,6 +408,39 @@ UX_FLOW(ux_display_message_flow,
         &ux_display_approve_step,
         &ux_display_reject_step);
 
+// Step with title/text for the length of a chunked message
+UX_STEP_NOCB(ux_display_message_len_step,
+             bnnn_paging,
+             {
+                 .title = "Message Length",
+                 .text = g_message_len,
+             });
+
+// Step with title/text for the hash of a chunked message
+UX_STEP_NOCB(ux_display_message_hash_step,
+             bnnn_paging,
+             {
+                 .title = "Message Hash",
+                 .text = g_message_hash,
+             });
+
+// FLOW to display a message sent in chunks, only its start is shown:
+// #1 screen: eye icon + "Review Message"
+// #2 screen: display BIP32 Path
+// #3 screen: display the start of the message
+// #4 screen: display the length of the message
+// #5 screen: display the hash of the message
+// #6 screen: approve button
+// #7 screen: reject button
+UX_FLOW(ux_display_chunked_message_flow,
+        &ux_display_confirm_message_step,
+        &ux_display_path_step,
+        &ux_display_message_step,
+        &ux_display_message_len_step,
+        &ux_display_message_hash_step,
+        &ux_display_approve_step,
+        &ux_display_reject_step);
+
 int ui_display_message() {
     if (G_context.req_type != CONFIRM_MESSAGE || G_context.state != STATE_NONE) {
         G_context.state = STATE_NONE;
@@ -269,13 +457,34 @@ int ui_display_message() {
 
     memset(g_message, 0, sizeof(g_message));
 
+    // Only the start of a long chunked message is kept, leave room to say so
+    bool truncated = G_context.msg_info.message_len < G_context.msg_info.message_total_len;
+
     format_message_to_sign(g_message,
-                           (int) sizeof(g_message),
+                           (int) sizeof(g_message) - (truncated ? 4 : 0),
                            (char *) G_context.msg_info.message,
                            (int) G_context.msg_info.message_len);
+    if (truncated) {
+        strncat(g_message, "...", 3);
+    }
 
     g_validate_callback = &ui_action_validate_message;
 
+    if (G_context.msg_info.chunked) {
+        snprintf(g_message_len,
+                 sizeof(g_message_len),
+                 "%u bytes",
+                 (unsigned int) G_context.msg_info.message_total_len);
+
+        format_hex(G_context.msg_info.message_hash,
+                   sizeof(G_context.msg_info.message_hash),
+                   g_message_hash,
+                   sizeof(g_message_hash));
+
+        ux_flow_init(0, ux_display_chunked_message_flow, NULL);
+        return 0;
+    }
+
     ux_flow_init(0, ux_display_message_flow, NULL);
     return 0;
 }
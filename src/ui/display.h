@@ -38,6 +38,15 @@ typedef void (*action_validate_cb)(bool);
  */
 int ui_display_address(void);
 
+/**
+ * Display the account whose public key is requested on the device and
+ * ask confirmation to export it.
+ *
+ * @return 0 if success, negative integer otherwise.
+ *
+ */
+int ui_display_account_public_key(void);
+
 /**
  * Display transaction information on the device and ask confirmation to sign.
  *
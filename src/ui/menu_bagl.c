@@ -28,12 +28,19 @@
 #include "glyphs.h"
 
 #include "../globals.h"
+#include "../pubkey_cache.h"
 #include "menu.h"
 
+static void app_quit(void) {
+    pubkey_cache_clear();
+    // exit app here
+    os_sched_exit(-1);
+}
+
 UX_STEP_NOCB(ux_menu_ready_step, pnn, {&C_kaspa_logo, APPNAME, "is ready"});
 UX_STEP_NOCB(ux_menu_version_step, bn, {"Version", APPVERSION});
 UX_STEP_CB(ux_menu_about_step, pb, ui_menu_about(), {&C_icon_certificate, "About"});
-UX_STEP_VALID(ux_menu_exit_step, pb, os_sched_exit(-1), {&C_icon_dashboard_x, "Quit"});
+UX_STEP_VALID(ux_menu_exit_step, pb, app_quit(), {&C_icon_dashboard_x, "Quit"});
 
 // FLOW for the main menu:
 // #1 screen: ready
@@ -28,6 +28,7 @@
 #include "nbgl_use_case.h"
 
 #include "../globals.h"
+#include "../pubkey_cache.h"
 #include "menu.h"
 
 //  -----------------------------------------------------------
@@ -35,6 +36,7 @@
 //  -----------------------------------------------------------
 
 void app_quit(void) {
+    pubkey_cache_clear();
     // exit app here
     os_sched_exit(-1);
 }
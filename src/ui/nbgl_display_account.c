@@ -0,0 +1,88 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#ifdef HAVE_NBGL
+
+#include <stdbool.h>  // bool
+#include <string.h>   // memset
+
+#include "os.h"
+#include "glyphs.h"
+#include "nbgl_use_case.h"
+#include "io.h"
+#include "bip32.h"
+
+#include "display.h"
+#include "../globals.h"
+#include "../sw.h"
+#include "action/validate.h"
+#include "../menu.h"
+
+static char g_bip32_path[60];
+
+static nbgl_layoutTagValue_t pairs[1];
+static nbgl_layoutTagValueList_t pairList;
+
+static void review_choice(bool confirm) {
+    // Answer, display a status page and go back to main
+    validate_pubkey(confirm);
+    if (confirm) {
+        nbgl_useCaseStatus("Account key\nexported", true, ui_menu_main);
+    } else {
+        nbgl_useCaseStatus("Account key\nnot exported", false, ui_menu_main);
+    }
+}
+
+int ui_display_account_public_key() {
+    if (G_context.req_type != CONFIRM_ADDRESS || G_context.state != STATE_NONE) {
+        G_context.state = STATE_NONE;
+        return io_send_sw(SW_BAD_STATE);
+    }
+
+    memset(g_bip32_path, 0, sizeof(g_bip32_path));
+    if (!bip32_path_format(G_context.bip32_path,
+                           G_context.bip32_path_len,
+                           g_bip32_path,
+                           sizeof(g_bip32_path))) {
+        return io_send_sw(SW_DISPLAY_BIP32_PATH_FAIL);
+    }
+
+    // Fill pairs
+    pairs[0].item = "BIP32 Path";
+    pairs[0].value = g_bip32_path;
+
+    pairList.nbMaxLinesForValue = 0;
+    pairList.nbPairs = 1;
+    pairList.pairs = pairs;
+
+    nbgl_useCaseReview(TYPE_OPERATION,
+                       &pairList,
+                       &C_stax_app_kaspa_64px,
+                       "Export account\npublic key",
+                       "Every address of this account can be derived from it",
+                       "Export account\npublic key?",
+                       review_choice);
+    return 0;
+}
+
+#endif
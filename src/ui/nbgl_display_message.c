@@ -45,10 +45,12 @@
 #include "../common/format_local.h"
 #include "../menu.h"
 
-static char g_message[MAX_MESSAGE_LEN];
+static char g_message[MAX_MESSAGE_LEN + 4];
 static char g_bip32_path[60];
+static char g_message_len[20];
+static char g_message_hash[65];
 
-static nbgl_layoutTagValue_t pairs[2];
+static nbgl_layoutTagValue_t pairs[4];
 static nbgl_layoutTagValueList_t pairList;
 
 static void review_message_choice(bool confirm) {
@@ -75,10 +77,17 @@ int ui_display_message() {
     }
 
     memset(g_message, 0, sizeof(g_message));
+
+    // Only the start of a long chunked message is kept, leave room to say so
+    bool truncated = G_context.msg_info.message_len < G_context.msg_info.message_total_len;
+
     format_message_to_sign(g_message,
-                           sizeof(g_message),
+                           sizeof(g_message) - 4,
                            (char *) G_context.msg_info.message,
                            G_context.msg_info.message_len);
+    if (truncated) {
+        strncat(g_message, "...", 3);
+    }
 
     // Fill pairs
     pairs[0].item = "BIP32 Path";
@@ -91,6 +100,24 @@ int ui_display_message() {
     pairList.nbPairs = 2;
     pairList.pairs = pairs;
 
+    if (G_context.msg_info.chunked) {
+        snprintf(g_message_len,
+                 sizeof(g_message_len),
+                 "%u bytes",
+                 (unsigned int) G_context.msg_info.message_total_len);
+
+        format_hex(G_context.msg_info.message_hash,
+                   sizeof(G_context.msg_info.message_hash),
+                   g_message_hash,
+                   sizeof(g_message_hash));
+
+        pairs[2].item = "Message length";
+        pairs[2].value = g_message_len;
+        pairs[3].item = "Message hash";
+        pairs[3].value = g_message_hash;
+        pairList.nbPairs = 4;
+    }
+
     // Start review flow
     nbgl_useCaseReview(TYPE_MESSAGE,
                        &pairList,
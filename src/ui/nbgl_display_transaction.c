@@ -44,12 +44,17 @@
 #include "../transaction/types.h"
 #include "../transaction/utils.h"
 #include "../menu.h"
+#include "../handler/debug.h"
 
 // Buffer where the transaction amount string is written
 static char g_amount[30];
 // Buffer where the transaction address string is written
 static char g_address[ECDSA_ADDRESS_LEN + 6];
 static char g_fees[30];
+// Title of the amount of the output being reviewed, when there are several
+static char g_amount_title[20];
+// Index of the output being reviewed
+static size_t g_output_index;
 
 static nbgl_layoutTagValue_t pairs[3];
 static nbgl_layoutTagValueList_t pairList;
@@ -65,6 +70,114 @@ static void review_choice(bool confirm) {
     }
 }
 
+// Format the amount and address of an output to g_amount and g_address
+static bool format_output(size_t index) {
+#ifdef HAVE_DEBUG_APDU
+    if (G_debug_fail_next_output_format) {
+        G_debug_fail_next_output_format = false;
+        return false;
+    }
+#endif
+
+    memset(g_amount, 0, sizeof(g_amount));
+    char amount[30] = {0};
+    if (!format_fpu64_trimmed(amount,
+                              sizeof(amount),
+                              G_context.tx_info.transaction.tx_output_values[index],
+                              EXPONENT_SMALLEST_UNIT)) {
+        return false;
+    }
+    snprintf(g_amount, sizeof(g_amount), "KAS %.*s", sizeof(amount), amount);
+
+    memset(g_address, 0, sizeof(g_address));
+
+    uint8_t address[ECDSA_ADDRESS_LEN] = {0};
+
+    transaction_t *tx = &G_context.tx_info.transaction;
+    script_public_key_to_address(address,
+                                 sizeof(address),
+                                 tx->tx_scripts.data + tx->tx_output_script_offsets[index],
+                                 tx->tx_output_script_lens[index]);
+    snprintf(g_address, sizeof(g_address), "%.*s", ECDSA_ADDRESS_LEN, address);
+
+    return true;
+}
+
+static void review_output(void);
+
+// called when an output page of a review with several recipients is left
+static void review_output_choice(bool confirm) {
+    if (!confirm) {
+        review_choice(false);
+        return;
+    }
+
+    g_output_index++;
+    review_output();
+}
+
+// called when the fees page of a review with several recipients is left
+static void review_fees_choice(bool confirm) {
+    if (!confirm) {
+        review_choice(false);
+        return;
+    }
+
+    nbgl_useCaseReviewStreamingFinish("Sign transaction\nto send KAS", review_choice);
+}
+
+// Show the next output of a review with several recipients, one per page,
+// then the fees. Only the page on screen is formatted.
+static void review_output(void) {
+    size_t recipients = count_recipient_outputs(&G_context.tx_info.transaction);
+
+    if (g_output_index < recipients) {
+        if (!format_output(g_output_index)) {
+            abort_transaction(SW_DISPLAY_AMOUNT_FAIL);
+            ui_menu_main();
+            return;
+        }
+
+        snprintf(g_amount_title,
+                 sizeof(g_amount_title),
+                 "Amount %u/%u",
+                 (unsigned int) (g_output_index + 1),
+                 (unsigned int) recipients);
+
+        pairs[0].item = g_amount_title;
+        pairs[0].value = g_amount;
+        pairs[1].item = "To";
+        pairs[1].value = g_address;
+
+        pairList.nbMaxLinesForValue = 0;
+        pairList.nbPairs = 2;
+        pairList.pairs = pairs;
+
+        nbgl_useCaseReviewStreamingContinue(&pairList, review_output_choice);
+        return;
+    }
+
+    pairs[0].item = "Fees";
+    pairs[0].value = g_fees;
+
+    pairList.nbMaxLinesForValue = 0;
+    pairList.nbPairs = 1;
+    pairList.pairs = pairs;
+
+    nbgl_useCaseReviewStreamingContinue(&pairList, review_fees_choice);
+}
+
+// called when the first page of a review with several recipients is left
+static void review_start_choice(bool confirm) {
+    if (!confirm) {
+        review_choice(false);
+        return;
+    }
+
+    g_output_index = 0;
+    review_output();
+}
+
 // Public function to start the transaction review
 // - Check if the app is in the right state for transaction review
 // - Format the amount and address strings in g_amount, g-fees and g_address buffers
@@ -75,39 +188,33 @@ int ui_display_transaction() {
         return io_send_sw(SW_BAD_STATE);
     }
 
-    // Format amount and address to g_amount and g_address buffers
-    memset(g_amount, 0, sizeof(g_amount));
-    char amount[30] = {0};
-    if (!format_fpu64_trimmed(amount,
-                              sizeof(amount),
-                              G_context.tx_info.transaction.tx_outputs[0].value,
-                              EXPONENT_SMALLEST_UNIT)) {
-        return io_send_sw(SW_DISPLAY_AMOUNT_FAIL);
-    }
-    snprintf(g_amount, sizeof(g_amount), "KAS %.*s", sizeof(amount), amount);
     memset(g_fees, 0, sizeof(g_fees));
 
     char fees[30] = {0};
     if (!format_fpu64_trimmed(fees,
                               sizeof(fees),
-                              calc_fees(G_context.tx_info.transaction.tx_inputs,
-                                        G_context.tx_info.transaction.tx_input_len,
-                                        G_context.tx_info.transaction.tx_outputs,
-                                        G_context.tx_info.transaction.tx_output_len),
+                              calc_fees(G_context.tx_info.input_total,
+                                        G_context.tx_info.output_total),
                               EXPONENT_SMALLEST_UNIT)) {
-        return io_send_sw(SW_DISPLAY_AMOUNT_FAIL);
+        return abort_transaction(SW_DISPLAY_AMOUNT_FAIL);
     }
     snprintf(g_fees, sizeof(g_fees), "KAS %.*s", sizeof(fees), fees);
-    memset(g_address, 0, sizeof(g_address));
 
-    uint8_t address[ECDSA_ADDRESS_LEN] = {0};
+    if (count_recipient_outputs(&G_context.tx_info.transaction) > 1) {
+        // Batch payouts are reviewed one output per page, so that only the
+        // strings on screen are kept whatever the number of outputs
+        nbgl_useCaseReviewStreamingStart(TYPE_TRANSACTION,
+                                         &C_stax_app_kaspa_64px,
+                                         "Review transaction\nto send KAS",
+                                         NULL,
+                                         review_start_choice);
+        return 0;
+    }
 
-    script_public_key_to_address(
-        address,
-        sizeof(address),
-        G_context.tx_info.transaction.tx_outputs[0].script_public_key,
-        sizeof(G_context.tx_info.transaction.tx_outputs[0].script_public_key));
-    snprintf(g_address, sizeof(g_address), "%.*s", ECDSA_ADDRESS_LEN, address);
+    // Format amount and address to g_amount and g_address buffers
+    if (!format_output(0)) {
+        return abort_transaction(SW_DISPLAY_AMOUNT_FAIL);
+    }
 
     // Setup data to display
     pairs[0].item = "Amount";
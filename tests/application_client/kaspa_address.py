@@ -0,0 +1,56 @@
+from typing import List
+
+
+SCHNORR: int = 0
+ECDSA: int = 1
+P2SH: int = 2
+
+CHARSET: str = "qpzry9x8gf2tvdw0s3jn54khce6mua7l"
+PREFIX: str = "kaspa"
+
+
+def polymod(values: List[int]) -> int:
+    generators = [0x98f2bc8e61, 0x79b76d99e2, 0xf33e5fb3c4, 0xae2eabe2a8, 0x1e4f43e470]
+    c = 1
+    for value in values:
+        b = c >> 35
+        c = ((c & 0x07ffffffff) << 5) ^ value
+        for i, generator in enumerate(generators):
+            if (b >> i) & 1:
+                c ^= generator
+    return c ^ 1
+
+
+def convert_bits(data: bytes, from_bits: int, to_bits: int) -> List[int]:
+    acc = 0
+    bits = 0
+    out = []
+    maxv = (1 << to_bits) - 1
+    for value in data:
+        acc = (acc << from_bits) | value
+        bits += from_bits
+        while bits >= to_bits:
+            bits -= to_bits
+            out.append((acc >> bits) & maxv)
+    if bits:
+        out.append((acc << (to_bits - bits)) & maxv)
+    return out
+
+
+# Same as address_from_pubkey() in src/address.c,
+# public_key is X || Y (64 bytes) or X only for SCHNORR and P2SH
+def address_from_public_key(public_key: bytes, address_type: int = SCHNORR) -> str:
+    if address_type == SCHNORR:
+        version, payload = 0, public_key[:32]
+    elif address_type == ECDSA:
+        version, payload = 1, bytes([0x02 | (public_key[63] & 1)]) + public_key[:32]
+    elif address_type == P2SH:
+        version, payload = 8, public_key[:32]
+    else:
+        raise ValueError(f"Unknown address type {address_type}")
+
+    data = convert_bits(bytes([version]) + payload, 8, 5)
+    mod = polymod([ord(c) & 0x1f for c in PREFIX] + [0] + data + [0] * 8)
+    checksum = [(mod >> (5 * (7 - i))) & 0x1f for i in range(8)]
+
+    return PREFIX + ":" + "".join(CHARSET[d] for d in data + checksum)
@@ -0,0 +1,80 @@
+import hmac
+from hashlib import sha512
+from typing import Optional, Tuple
+
+
+# secp256k1
+P: int = 2**256 - 2**32 - 977
+N: int = 0xFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141
+G: Tuple[int, int] = (0x79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798,
+                      0x483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8)
+
+Point = Optional[Tuple[int, int]]
+
+
+def point_add(p: Point, q: Point) -> Point:
+    if p is None:
+        return q
+    if q is None:
+        return p
+    if p[0] == q[0] and (p[1] + q[1]) % P == 0:
+        return None
+    if p == q:
+        lam = 3 * p[0] * p[0] * pow(2 * p[1], -1, P) % P
+    else:
+        lam = (q[1] - p[1]) * pow(q[0] - p[0], -1, P) % P
+    x = (lam * lam - p[0] - q[0]) % P
+    return x, (lam * (p[0] - x) - p[1]) % P
+
+
+def point_mul(k: int, p: Point) -> Point:
+    result: Point = None
+    while k:
+        if k & 1:
+            result = point_add(result, p)
+        p = point_add(p, p)
+        k >>= 1
+    return result
+
+
+def serialize_point(p: Tuple[int, int]) -> bytes:
+    return bytes([0x02 | (p[1] & 1)]) + p[0].to_bytes(32, byteorder="big")
+
+
+# Public key as sent back by GET_PUBLIC_KEY, 0x04 || X || Y
+def parse_uncompressed_point(public_key: bytes) -> Tuple[int, int]:
+    assert len(public_key) == 65 and public_key[0] == 0x04
+    return int.from_bytes(public_key[1:33], byteorder="big"), \
+           int.from_bytes(public_key[33:], byteorder="big")
+
+
+class ExtendedPublicKey:
+    def __init__(self, public_key: bytes, chain_code: bytes):
+        self.point: Tuple[int, int] = parse_uncompressed_point(public_key)
+        self.chain_code: bytes = chain_code
+
+    # CKDpub from BIP32, only for non-hardened indexes
+    def derive_child(self, index: int) -> "ExtendedPublicKey":
+        assert 0 <= index < 0x80000000
+
+        data = serialize_point(self.point) + index.to_bytes(4, byteorder="big")
+        I = hmac.new(self.chain_code, data, sha512).digest()
+        tweak = int.from_bytes(I[:32], byteorder="big")
+        assert tweak < N
+
+        child = point_add(point_mul(tweak, G), self.point)
+        assert child is not None
+
+        return ExtendedPublicKey(b"\x04" + child[0].to_bytes(32, byteorder="big") +
+                                 child[1].to_bytes(32, byteorder="big"),
+                                 I[32:])
+
+    def derive(self, address_type: int, address_index: int) -> "ExtendedPublicKey":
+        return self.derive_child(address_type).derive_child(address_index)
+
+    def public_key(self) -> bytes:
+        return b"\x04" + self.point[0].to_bytes(32, byteorder="big") + \
+               self.point[1].to_bytes(32, byteorder="big")
+
+    def x_only(self) -> bytes:
+        return self.point[0].to_bytes(32, byteorder="big")
@@ -5,24 +5,40 @@ from contextlib import contextmanager
 from ragger.backend.interface import BackendInterface, RAPDU
 from ragger.bip import pack_derivation_path
 
-from .kaspa_transaction import Transaction
+from .kaspa_transaction import Transaction, TransactionInput
 from .kaspa_message import PersonalMessage
 
 
 MAX_APDU_LEN: int = 255
 
+# Serialized inputs that fit in one P1_INPUTS APDU
+MAX_INPUTS_PER_APDU: int = 5
+
+INPUT_COMMITMENT_LEN: int = 32
+
 CLA: int = 0xE0
 
+# P1 of the debug APDU for the key derivation counters, see src/handler/debug.h
+DEBUG_KEY_DERIVATION_STATS: int = 0x11
+# P1 of the debug APDU making the next output formatted for review fail
+DEBUG_FAIL_NEXT_OUTPUT_FORMAT: int = 0x12
+
 class P1(IntEnum):
     # Parameter 1 for first APDU number.
     P1_START = 0x00
     P1_OUTPUTS = 0x01
     P1_INPUTS = 0x02
     P1_NEXT_SIGNATURE = 0x03
+    P1_START_STREAMED = 0x04
+    P1_SIGN_INPUT = 0x05
+    P1_NEXT_SIGNATURES = 0x06
     # Parameter 1 for maximum APDU number.
-    P1_MAX   = 0x03
+    P1_MAX   = 0x06
     # Parameter 1 for screen confirmation for GET_PUBLIC_KEY.
     P1_CONFIRM = 0x01
+    # Parameter 1 for SIGN_MESSAGE with the message sent in chunks.
+    P1_MESSAGE_START_CHUNKED = 0x10
+    P1_MESSAGE_CHUNK = 0x11
 
 class P2(IntEnum):
     # Parameter 2 for last APDU to receive.
@@ -36,6 +52,9 @@ class InsType(IntEnum):
     GET_PUBLIC_KEY = 0x05
     SIGN_TX        = 0x06
     SIGN_MESSAGE   = 0x07
+    GET_PUBLIC_KEYS = 0x08
+    GET_ACCOUNT_PUBLIC_KEY = 0x09
+    DEBUG          = 0xde
 
 class Errors(IntEnum):
     SW_DENY                       = 0x6985
@@ -55,6 +74,9 @@ class Errors(IntEnum):
     SW_WRONG_BIP32_PURPOSE        = 0xB009
     SW_WRONG_BIP32_COIN_TYPE      = 0xB00A
     SW_WRONG_BIP32_PATH_LEN       = 0xB00B
+    SW_INPUT_COMMITMENT_FAIL      = 0xB00C
+    SW_WRONG_BIP32_ACCOUNT        = 0xB00D
+    SW_WRONG_BIP32_ADDRESS_TYPE   = 0xB00E
     SW_MESSAGE_PARSING_FAIL       = 0xB010
     SW_MESSAGE_TOO_LONG           = 0xB011
     SW_MESSAGE_TOO_SHORT          = 0xB012
@@ -66,6 +88,10 @@ class Errors(IntEnum):
 def split_message(message: bytes, max_size: int) -> List[bytes]:
     return [message[x:x + max_size] for x in range(0, len(message), max_size)]
 
+def pack_inputs(inputs: List[TransactionInput], inputs_per_apdu: int) -> List[bytes]:
+    return [b"".join(txinput.serialize() for txinput in inputs[x:x + inputs_per_apdu])
+            for x in range(0, len(inputs), inputs_per_apdu)]
+
 class KaspaCommandSender:
     def __init__(self, backend: BackendInterface) -> None:
         self.backend = backend
@@ -103,6 +129,17 @@ class KaspaCommandSender:
                                      data=pack_derivation_path(path))
 
 
+    def get_public_keys(self, account: int, address_type: int, first_index: int, count: int) -> RAPDU:
+        return self.backend.exchange(cla=CLA,
+                                     ins=InsType.GET_PUBLIC_KEYS,
+                                     p1=P1.P1_START,
+                                     p2=P2.P2_LAST,
+                                     data=account.to_bytes(4, byteorder='big') +
+                                          address_type.to_bytes(1, byteorder='big') +
+                                          first_index.to_bytes(4, byteorder='big') +
+                                          count.to_bytes(1, byteorder='big'))
+
+
     @contextmanager
     def get_public_key_with_confirmation(self, path: str) -> Generator[None, None, None]:
         with self.backend.exchange_async(cla=CLA,
@@ -113,13 +150,34 @@ class KaspaCommandSender:
             yield response
 
 
+    def get_account_public_key(self, account: int) -> RAPDU:
+        return self.backend.exchange(cla=CLA,
+                                     ins=InsType.GET_ACCOUNT_PUBLIC_KEY,
+                                     p1=P1.P1_START,
+                                     p2=P2.P2_LAST,
+                                     data=account.to_bytes(4, byteorder='big'))
+
+
+    @contextmanager
+    def get_account_public_key_with_confirmation(self, account: int) -> Generator[None, None, None]:
+        with self.backend.exchange_async(cla=CLA,
+                                         ins=InsType.GET_ACCOUNT_PUBLIC_KEY,
+                                         p1=P1.P1_CONFIRM,
+                                         p2=P2.P2_LAST,
+                                         data=account.to_bytes(4, byteorder='big')) as response:
+            yield response
+
+
     @contextmanager
-    def sign_tx(self, transaction: Transaction) -> Generator[None, None, None]:
+    def sign_tx(self,
+                transaction: Transaction,
+                sign_eagerly: bool = False,
+                inputs_per_apdu: int = 1) -> Generator[None, None, None]:
         self.backend.exchange(cla=CLA,
                               ins=InsType.SIGN_TX,
                               p1=P1.P1_START,
                               p2=P2.P2_MORE,
-                              data=transaction.serialize_first_chunk())
+                              data=transaction.serialize_first_chunk(sign_eagerly))
 
         for txoutput in transaction.outputs:
             self.backend.exchange(cla=CLA,
@@ -128,24 +186,72 @@ class KaspaCommandSender:
                                   p2=P2.P2_MORE,
                                   data=txoutput.serialize())
 
-        txinput = None # used again after the loop for the last value
-        for i, txinput in enumerate(transaction.inputs):
-            if i < len(transaction.inputs) - 1:
-                self.backend.exchange(cla=CLA,
+        chunks = pack_inputs(transaction.inputs, inputs_per_apdu)
+        for chunk in chunks[:-1]:
+            self.backend.exchange(cla=CLA,
+                                  ins=InsType.SIGN_TX,
+                                  p1=P1.P1_INPUTS,
+                                  p2=P2.P2_MORE,
+                                  data=chunk)
+
+        # Last inputs, we'll end here
+        with self.backend.exchange_async(cla=CLA,
                                     ins=InsType.SIGN_TX,
                                     p1=P1.P1_INPUTS,
-                                    p2=P2.P2_MORE,
-                                    data=txinput.serialize())
+                                    p2=P2.P2_LAST,
+                                    data=chunks[-1]) as response:
+
+            yield response
+
+    @contextmanager
+    def sign_tx_streamed(self,
+                         transaction: Transaction,
+                         inputs_per_apdu: int = MAX_INPUTS_PER_APDU) -> Generator[None, None, None]:
+        # Commitments of the inputs, those of the last APDU are in the response after approval
+        self.input_commitments = []
+
+        self.backend.exchange(cla=CLA,
+                              ins=InsType.SIGN_TX,
+                              p1=P1.P1_START_STREAMED,
+                              p2=P2.P2_MORE,
+                              data=transaction.serialize_first_chunk_streamed())
+
+        for txoutput in transaction.outputs:
+            self.backend.exchange(cla=CLA,
+                                  ins=InsType.SIGN_TX,
+                                  p1=P1.P1_OUTPUTS,
+                                  p2=P2.P2_MORE,
+                                  data=txoutput.serialize())
+
+        chunks = pack_inputs(transaction.inputs, inputs_per_apdu)
+        for chunk in chunks[:-1]:
+            rapdu = self.backend.exchange(cla=CLA,
+                                          ins=InsType.SIGN_TX,
+                                          p1=P1.P1_INPUTS,
+                                          p2=P2.P2_MORE,
+                                          data=chunk)
+            self.input_commitments += split_message(rapdu.data, INPUT_COMMITMENT_LEN)
 
-        # Last input, we'll end here
+        # Last inputs, we'll end here
         with self.backend.exchange_async(cla=CLA,
                                     ins=InsType.SIGN_TX,
                                     p1=P1.P1_INPUTS,
                                     p2=P2.P2_LAST,
-                                    data=txinput.serialize()) as response:
+                                    data=chunks[-1]) as response:
 
             yield response
 
+    def sign_streamed_input(self, txinput: TransactionInput, index: int, commitment: bytes) -> RAPDU:
+        return self.backend.exchange(cla=CLA,
+                                     ins=InsType.SIGN_TX,
+                                     p1=P1.P1_SIGN_INPUT,
+                                     p2=P2.P2_LAST,
+                                     data=b"".join([
+                                         txinput.serialize(),
+                                         index.to_bytes(2, byteorder="big"),
+                                         commitment
+                                     ]))
+
     @contextmanager
     def sign_message(self, message_data: PersonalMessage) -> Generator[None, None, None]:
         with self.backend.exchange_async(cla=CLA,
@@ -155,12 +261,57 @@ class KaspaCommandSender:
                                          data=message_data.serialize()) as response:
             yield response
 
+    @contextmanager
+    def sign_message_chunked(self, message_data: PersonalMessage, chunk_len: int = MAX_APDU_LEN) -> Generator[None, None, None]:
+        self.backend.exchange(cla=CLA,
+                              ins=InsType.SIGN_MESSAGE,
+                              p1=P1.P1_MESSAGE_START_CHUNKED,
+                              p2=P2.P2_MORE,
+                              data=message_data.serialize_chunked_start())
+
+        chunks = split_message(message_data.message, chunk_len)
+        for chunk in chunks[:-1]:
+            self.backend.exchange(cla=CLA,
+                                  ins=InsType.SIGN_MESSAGE,
+                                  p1=P1.P1_MESSAGE_CHUNK,
+                                  p2=P2.P2_MORE,
+                                  data=chunk)
+
+        with self.backend.exchange_async(cla=CLA,
+                                         ins=InsType.SIGN_MESSAGE,
+                                         p1=P1.P1_MESSAGE_CHUNK,
+                                         p2=P2.P2_LAST,
+                                         data=chunks[-1]) as response:
+            yield response
+
     def get_next_signature(self) -> RAPDU:
         return self.backend.exchange(cla=CLA,
                                     ins=InsType.SIGN_TX,
                                     p1=P1.P1_NEXT_SIGNATURE,
                                     p2=P2.P2_LAST)
 
+    def get_next_signatures(self, with_sighash: bool = True) -> RAPDU:
+        flags = 0x00 if with_sighash else 0x01
+        return self.backend.exchange(cla=CLA,
+                                    ins=InsType.SIGN_TX,
+                                    p1=P1.P1_NEXT_SIGNATURES,
+                                    p2=P2.P2_LAST,
+                                    data=flags.to_bytes(1, byteorder="big"))
+
+    # Only answered when the app is built with HAVE_DEBUG_APDU
+    def get_key_derivation_stats(self) -> RAPDU:
+        return self.backend.exchange(cla=CLA,
+                                    ins=InsType.DEBUG,
+                                    p1=DEBUG_KEY_DERIVATION_STATS,
+                                    p2=P2.P2_LAST)
+
+    # Only answered when the app is built with HAVE_DEBUG_APDU
+    def fail_next_output_format(self) -> RAPDU:
+        return self.backend.exchange(cla=CLA,
+                                    ins=InsType.DEBUG,
+                                    p1=DEBUG_FAIL_NEXT_OUTPUT_FORMAT,
+                                    p2=P2.P2_LAST)
+
     def get_async_response(self) -> Optional[RAPDU]:
         return self.backend.last_async_response
 
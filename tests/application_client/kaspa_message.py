@@ -24,6 +24,15 @@ class PersonalMessage:
             self.message
         ])
 
+    # First APDU of a message sent in chunks, the message follows in the next ones
+    def serialize_chunked_start(self) -> bytes:
+        return b"".join([
+            self.address_type.to_bytes(1, byteorder="big"),
+            self.address_index.to_bytes(4, byteorder="big"),
+            self.account.to_bytes(4, byteorder="big"),
+            len(self.message).to_bytes(2, byteorder="big")
+        ])
+
     def to_hash(self) -> bytes:
         outer_hash = hash_init()
         outer_hash.update(self.message)
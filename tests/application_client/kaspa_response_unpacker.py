@@ -57,6 +57,22 @@ def unpack_get_public_key_response(response: bytes) -> Tuple[int, bytes, int, by
 
     return pub_key_len, pub_key, chain_code_len, chain_code
 
+# Unpack from response:
+# response = count (1)
+#            count times:
+#              pub_key (32)
+def unpack_get_public_keys_response(response: bytes) -> list[bytes]:
+    response, count = pop_sized_buf_from_buffer(response, 1)
+
+    public_keys = []
+    for _ in range(int.from_bytes(count, byteorder='big')):
+        response, public_key = pop_sized_buf_from_buffer(response, 32)
+        public_keys.append(public_key)
+
+    assert len(response) == 0
+
+    return public_keys
+
 # Unpack from response:
 # response = has_more (1)
 #            input_index (1)
@@ -79,6 +95,52 @@ def unpack_sign_tx_response(response: bytes) -> Tuple[int, int, int, bytes, int,
            sighash_len, \
            sighash
 
+# Unpack from response:
+# response = has_more (1)
+#            count (1)
+#            count times:
+#              input_index (1)
+#              der_sig_len (1)
+#              der_sig (64)
+#              [sighash_len (1)
+#              sighash (32)]
+def unpack_sign_tx_batch_response(response: bytes,
+                                  with_sighash: bool = True) -> Tuple[int, list[Tuple[int, bytes, bytes]]]:
+    response, has_more = pop_sized_buf_from_buffer(response, 1)
+    response, count = pop_sized_buf_from_buffer(response, 1)
+
+    records = []
+    for _ in range(int.from_bytes(count, byteorder='big')):
+        response, input_index = pop_sized_buf_from_buffer(response, 1)
+        response, _, der_sig = pop_size_prefixed_buf_from_buf(response)
+        sighash = b""
+        if with_sighash:
+            response, _, sighash = pop_size_prefixed_buf_from_buf(response)
+        records.append((int.from_bytes(input_index, byteorder='big'), der_sig, sighash))
+
+    assert len(response) == 0
+
+    return int.from_bytes(has_more, byteorder='big'), records
+
+# Unpack from response:
+# response = input_index (2)
+#            der_sig_len (1)
+#            der_sig (64)
+#            sighash_len (1)
+#            sighash (32)
+def unpack_sign_streamed_input_response(response: bytes) -> Tuple[int, int, bytes, int, bytes]:
+    response, input_index = pop_sized_buf_from_buffer(response, 2)
+    response, der_sig_len, der_sig = pop_size_prefixed_buf_from_buf(response)
+    response, sighash_len, sighash = pop_size_prefixed_buf_from_buf(response)
+
+    assert len(response) == 0
+
+    return int.from_bytes(input_index, byteorder='big'), \
+           der_sig_len, \
+           der_sig, \
+           sighash_len, \
+           sighash
+
 # Unpack from response:
 # response = der_sig_len (1)
 #            der_sig (64)
@@ -94,3 +156,11 @@ def unpack_sign_message_response(response: bytes) -> Tuple[int, bytes, int, byte
            der_sig, \
            mhash_len, \
            mhash
+
+# Unpack from response:
+# response = derived (2)
+#            reused (2)
+def unpack_key_derivation_stats_response(response: bytes) -> Tuple[int, int]:
+    assert len(response) == 4
+    derived, reused = unpack(">HH", response)
+    return (derived, reused)
@@ -98,7 +98,7 @@ class Transaction:
             if not 0 <= self.version <= 1:
                 raise TransactionError(f"Bad version: '{self.version}'!")
 
-    def serialize_first_chunk(self) -> bytes:
+    def serialize_first_chunk(self, sign_eagerly: bool = False) -> bytes:
         return b"".join([
             self.version.to_bytes(2, byteorder="big"),
             len(self.outputs).to_bytes(1, byteorder="big"),
@@ -106,6 +106,17 @@ class Transaction:
             self.change_address_type.to_bytes(1, byteorder="big"),
             self.change_address_index.to_bytes(4, byteorder="big"),
             self.account.to_bytes(4, byteorder="big"),
+            (0x01).to_bytes(1, byteorder="big") if sign_eagerly else b"",
+        ])
+
+    def serialize_first_chunk_streamed(self) -> bytes:
+        return b"".join([
+            self.version.to_bytes(2, byteorder="big"),
+            len(self.outputs).to_bytes(1, byteorder="big"),
+            len(self.inputs).to_bytes(2, byteorder="big"),
+            self.change_address_type.to_bytes(1, byteorder="big"),
+            self.change_address_index.to_bytes(4, byteorder="big"),
+            self.account.to_bytes(4, byteorder="big"),
         ])
 
     def serialize(self) -> bytes:
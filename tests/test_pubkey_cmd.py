@@ -1,7 +1,9 @@
 import pytest
 
 from application_client.kaspa_command_sender import KaspaCommandSender, Errors
-from application_client.kaspa_response_unpacker import unpack_get_public_key_response
+from application_client.kaspa_response_unpacker import unpack_get_public_key_response, unpack_get_public_keys_response
+from application_client.kaspa_bip32 import ExtendedPublicKey
+from application_client.kaspa_address import address_from_public_key, SCHNORR, ECDSA, P2SH
 from ragger.bip import calculate_public_key_and_chaincode, CurveChoice
 from ragger.backend import RaisePolicy
 from ragger.error import ExceptionRAPDU
@@ -35,6 +37,111 @@ def test_get_public_key_no_confirm_invalid(backend):
         assert client.get_public_key(path=test_case[0]).status == test_case[1]
 
 
+# GET_PUBLIC_KEYS returns the same keys as GET_PUBLIC_KEY for consecutive indexes
+def test_get_public_keys(backend):
+    client = KaspaCommandSender(backend)
+
+    for account, address_type, first_index in [(0x80000000, 0, 0), (0x80000000, 1, 20), (0x8000038f, 0, 5)]:
+        response = client.get_public_keys(account=account, address_type=address_type, first_index=first_index, count=8).data
+        public_keys = unpack_get_public_keys_response(response)
+
+        assert len(public_keys) == 8
+        for i, public_key in enumerate(public_keys):
+            path = f"m/44'/111111'/{account & 0x7FFFFFFF}'/{address_type}/{first_index + i}"
+            ref_public_key, _ = calculate_public_key_and_chaincode(CurveChoice.Secp256k1, path=path)
+            # 0x04 || X || Y, only X is sent back
+            assert public_key.hex() == ref_public_key[2:66]
+
+# GET_PUBLIC_KEYS matches the SDK derivation on both sides of the hardened boundary
+# of the address index, which goes through both branches of CKDpriv
+def test_get_public_keys_hardened_boundary(backend):
+    client = KaspaCommandSender(backend)
+
+    for account, address_type in [(0x80000000, 0), (0x8000038f, 1)]:
+        response = client.get_public_keys(account=account, address_type=address_type, first_index=0x7FFFFFFC, count=8).data
+        public_keys = unpack_get_public_keys_response(response)
+
+        assert len(public_keys) == 8
+        for i, public_key in enumerate(public_keys):
+            address_index = 0x7FFFFFFC + i
+            if address_index & 0x80000000:
+                address_level = f"{address_index & 0x7FFFFFFF}'"
+            else:
+                address_level = f"{address_index}"
+            path = f"m/44'/111111'/{account & 0x7FFFFFFF}'/{address_type}/{address_level}"
+            ref_public_key, _ = calculate_public_key_and_chaincode(CurveChoice.Secp256k1, path=path)
+            assert public_key.hex() == ref_public_key[2:66]
+
+# GET_PUBLIC_KEYS only sends back as many keys as fit in the response
+def test_get_public_keys_capped(backend):
+    client = KaspaCommandSender(backend)
+
+    response = client.get_public_keys(account=0x80000000, address_type=0, first_index=0, count=255).data
+    assert len(unpack_get_public_keys_response(response)) == 8
+
+    response = client.get_public_keys(account=0x80000000, address_type=0, first_index=0xFFFFFFFE, count=8).data
+    assert len(unpack_get_public_keys_response(response)) == 2
+
+# GET_PUBLIC_KEYS errors for malformed requests
+def test_get_public_keys_invalid(backend):
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    client = KaspaCommandSender(backend)
+
+    assert client.get_public_keys(account=0x80000000, address_type=0, first_index=0, count=0).status == Errors.SW_WRONG_DATA_LENGTH
+
+    # Accounts are hardened, addresses are either receive or change ones
+    assert client.get_public_keys(account=0x7FFFFFFF, address_type=0, first_index=0, count=1).status == Errors.SW_WRONG_BIP32_ACCOUNT
+    assert client.get_public_keys(account=0x80000000, address_type=2, first_index=0, count=1).status == Errors.SW_WRONG_BIP32_ADDRESS_TYPE
+
+# The host side address encoding matches address_from_pubkey() of the app, same vectors as unit-tests/test_address.c
+def test_address_from_public_key_reference():
+    for public_key, address_type, address in [
+        ("21eb0c4270128b16c93c5f0dac48d56051a6237dae997b58912695052818e348", SCHNORR, "kaspa:qqs7krzzwqfgk9kf830smtzg64s9rf3r0khfj76cjynf2pfgrr35saatu88xq"),
+        ("fa2b8572b618362a26128db388f04ed1a95cccd8e189f9c1bd6c57668b11b2d7", SCHNORR, "kaspa:qrazhptjkcvrv23xz2xm8z8sfmg6jhxvmrscn7wph4k9we5tzxedwfxf0v6f8"),
+        ("f38031f61ca23d70844f63a477d07f0b2c2decab907c2e096e548b0e08721c79", P2SH, "kaspa:precqv0krj3r6uyyfa36ga7s0u9jct0v4wg8ctsfde2gkrsgwgw8jgxfzfc98"),
+        ("d5fdc7ad11a65d0bbe7882fc3dbc91b5861d182dcce79f7c1be5bfd30a677cd6c562ad66abcdb1ec02f3e4b07c11bc5a94a685fedb5d5587076e48b12da6c282", ECDSA, "kaspa:qypdtlw845g6vhgtheug9lpahjgmtpsarqkueeul0sd7t07npfnhe4s7fd82n0v"),
+        ("e3100d85efae93e0c2fc654b2f0c33584f213a3fdffd023c821277b21789e064e06b454f5cba0eff1ce801d3835c39ec01ca949ca877c0b55bbdeca8ff8491d9", ECDSA, "kaspa:qyp7xyqdshh6aylqct7x2je0pse4snep8glallgz8jppyaajz7y7qeq4x79fq4z"),
+    ]:
+        assert address_from_public_key(bytes.fromhex(public_key), address_type) == address
+
+# Addresses derived on the host from GET_ACCOUNT_PUBLIC_KEY are the ones of the device
+def test_get_account_public_key_derivation(backend):
+    client = KaspaCommandSender(backend)
+
+    for account in [0x80000000, 0x8000038f]:
+        response = client.get_account_public_key(account=account).data
+        _, public_key, _, chain_code = unpack_get_public_key_response(response)
+
+        path = f"m/44'/111111'/{account & 0x7FFFFFFF}'"
+        ref_public_key, ref_chain_code = calculate_public_key_and_chaincode(CurveChoice.Secp256k1, path=path)
+        assert public_key.hex() == ref_public_key
+        assert chain_code.hex() == ref_chain_code
+
+        account_key = ExtendedPublicKey(public_key, chain_code)
+
+        for address_type in [0, 1]:
+            response = client.get_public_keys(account=account, address_type=address_type, first_index=0, count=8).data
+            device_keys = unpack_get_public_keys_response(response)
+
+            for address_index, device_key in enumerate(device_keys):
+                host_key = account_key.derive(address_type, address_index)
+                assert host_key.x_only() == device_key
+
+                path = f"m/44'/111111'/{account & 0x7FFFFFFF}'/{address_type}/{address_index}"
+                ref_public_key, _ = calculate_public_key_and_chaincode(CurveChoice.Secp256k1, path=path)
+                assert host_key.public_key().hex() == ref_public_key
+
+# GET_ACCOUNT_PUBLIC_KEY errors for malformed requests
+def test_get_account_public_key_invalid(backend):
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    rapdu = backend.exchange(cla=0xE0, ins=0x09, p1=0x00, p2=0x00, data=bytes(5))
+    assert rapdu.status == Errors.SW_WRONG_DATA_LENGTH
+
+    # The account level is hardened
+    rapdu = KaspaCommandSender(backend).get_account_public_key(account=0x7FFFFFFF)
+    assert rapdu.status == Errors.SW_WRONG_BIP32_ACCOUNT
+
 # In this test we check that the GET_PUBLIC_KEY works in confirmation mode
 def test_get_public_key_confirm_accepted(firmware, backend, scenario_navigator, test_name):
     client = KaspaCommandSender(backend)
@@ -1,9 +1,10 @@
 import pytest
 
 from application_client.kaspa_transaction import Transaction, TransactionInput, TransactionOutput
-from application_client.kaspa_command_sender import KaspaCommandSender, Errors, InsType, P1, P2
-from application_client.kaspa_response_unpacker import unpack_get_public_key_response, unpack_sign_tx_response
+from application_client.kaspa_command_sender import KaspaCommandSender, Errors, InsType, P1, P2, MAX_INPUTS_PER_APDU, INPUT_COMMITMENT_LEN, split_message
+from application_client.kaspa_response_unpacker import unpack_get_public_key_response, unpack_sign_tx_response, unpack_sign_tx_batch_response, unpack_sign_streamed_input_response, unpack_key_derivation_stats_response
 from ragger.backend import RaisePolicy
+from ragger.bip import calculate_public_key_and_chaincode, CurveChoice
 from ragger.error import ExceptionRAPDU
 from ragger.navigator import NavInsID
 from utils import ROOT_SCREENSHOT_PATH, check_signature_validity
@@ -11,6 +12,68 @@ from utils import ROOT_SCREENSHOT_PATH, check_signature_validity
 # In this tests we check the behavior of the device when asked to sign a transaction
 
 
+# A transaction spending input_count inputs of public_key that is reviewed
+# exactly like test_sign_tx_simple: the inputs add up to the same total and
+# the output is the same, so its snapshots can be reused
+def simple_transaction(public_key: bytes, input_count: int) -> Transaction:
+    inputs = [TransactionInput(
+                value=1100000 // input_count + (1100000 % input_count if input_index == 0 else 0),
+                tx_id="40b022362f1a303518e2b49f86f87a317c87b514ca0f3d08ad2e7cf49d08" + input_index.to_bytes(2, 'big').hex(),
+                address_type=0,
+                address_index=0,
+                index=0,
+                public_key=public_key[1:33]
+            ) for input_index in range(input_count)]
+
+    return Transaction(
+        version=0,
+        inputs=inputs,
+        outputs=[
+            TransactionOutput(
+                value=1090000,
+                script_public_key="2011a7215f668e921013eb7aac9b7e64b9ec6e757c1b648e89388c919f676aa88cac"
+            )
+        ]
+    )
+
+# Read the signature sent back with the approval then ask for the others one
+# by one. Returns the signature and sighash of each input index.
+def read_signatures(client: KaspaCommandSender, response: bytes) -> dict:
+    signatures = {}
+    while True:
+        has_more, input_index, _, der_sig, _, sighash = unpack_sign_tx_response(response)
+        assert input_index not in signatures
+        signatures[input_index] = (der_sig, sighash)
+
+        if has_more == 0:
+            return signatures
+        response = client.get_next_signature().data
+
+# A script paying to a key that only differs from the one of test_sign_tx_simple
+# by its last byte
+def recipient_script(recipient: int) -> str:
+    return "2011a7215f668e921013eb7aac9b7e64b9ec6e757c1b648e89388c919f676aa8" + recipient.to_bytes(1, 'big').hex() + "ac"
+
+# Approve a review of several recipients. Nano devices review them one at a
+# time, each ending with a Continue step, then the fees.
+def review_recipients_approve(firmware, navigator, scenario_navigator, test_name, recipients: int):
+    if not firmware.device.startswith("nano"):
+        scenario_navigator.review_approve()
+        return
+
+    for recipient in range(recipients):
+        navigator.navigate_until_text_and_compare(NavInsID.RIGHT_CLICK,
+                                                  [NavInsID.BOTH_CLICK],
+                                                  "Continue",
+                                                  ROOT_SCREENSHOT_PATH,
+                                                  f"{test_name}/output_{recipient + 1:02d}")
+    navigator.navigate_until_text_and_compare(NavInsID.RIGHT_CLICK,
+                                              [NavInsID.BOTH_CLICK],
+                                              "Approve",
+                                              ROOT_SCREENSHOT_PATH,
+                                              f"{test_name}/fees")
+
+
 # In this test se send to the device a transaction to sign and validate it on screen
 # We will ensure that the displayed information is correct by using screenshots comparison
 def test_sign_tx_simple(firmware, backend, scenario_navigator, test_name):
@@ -427,6 +490,47 @@ def test_sign_tx_with_invalid_change(backend):
 
     assert last_response.status == Errors.SW_TX_PARSING_FAIL
 
+def test_sign_tx_many_outputs_with_invalid_change(backend):
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    client = KaspaCommandSender(backend)
+
+    # The last of several outputs is the change, it must be ours
+    tx = Transaction(
+        version=0,
+        inputs=[
+            TransactionInput(
+                value=1100000,
+                tx_id="40b022362f1a303518e2b49f86f87a317c87b514ca0f3d08ad2e7cf49d08cc70",
+                address_type=0,
+                address_index=0,
+                index=0,
+                public_key=None
+            )
+        ],
+        outputs=[
+            TransactionOutput(
+                value=500000,
+                script_public_key="2011a7215f668e921013eb7aac9b7e64b9ec6e757c1b648e89388c919f676aa88cac"
+            ),
+            TransactionOutput(
+                value=500000,
+                script_public_key="2011a7215f668e921013eb7aac9b7e64b9ec6e757c1b648e89388c919f676aa88cac"
+            ),
+            TransactionOutput(
+                value=90000,
+                script_public_key="200000000000000000000000000000000000000000000000000000000000000000ac"
+            )
+        ]
+    )
+
+    assert client.send_raw_apdu(InsType.SIGN_TX, p1=P1.P1_START, p2=P2.P2_MORE, data=tx.serialize_first_chunk()).status == 0x9000
+    for txoutput in tx.outputs:
+        assert client.send_raw_apdu(InsType.SIGN_TX, p1=P1.P1_OUTPUTS, p2=P2.P2_MORE, data=txoutput.serialize()).status == 0x9000
+    last_response = client.send_raw_apdu(InsType.SIGN_TX, p1=P1.P1_INPUTS, p2=P2.P2_LAST, data=tx.inputs[0].serialize())
+
+    assert last_response.status == Errors.SW_TX_PARSING_FAIL
+
 def test_sign_tx_with_negative_fee(backend):
     backend.raise_policy = RaisePolicy.RAISE_NOTHING
 
@@ -460,13 +564,59 @@ def test_sign_tx_with_negative_fee(backend):
 
     assert last_response.status == Errors.SW_TX_PARSING_FAIL
 
+def test_sign_tx_value_overflow(backend):
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    client = KaspaCommandSender(backend)
+
+    max_input = TransactionInput(
+        value=0xFFFFFFFFFFFFFFFF,
+        tx_id="40b022362f1a303518e2b49f86f87a317c87b514ca0f3d08ad2e7cf49d08cc70",
+        address_type=0,
+        address_index=0,
+        index=0,
+        public_key=None
+    )
+    max_output = TransactionOutput(
+        value=0xFFFFFFFFFFFFFFFF,
+        script_public_key="2011a7215f668e921013eb7aac9b7e64b9ec6e757c1b648e89388c919f676aa88cac"
+    )
+    small_output = TransactionOutput(
+        value=1,
+        script_public_key="2011a7215f668e921013eb7aac9b7e64b9ec6e757c1b648e89388c919f676aa88cac"
+    )
+
+    # The values of two inputs add up past 2^64 - 1, they would wrap around to a small total
+    tx = Transaction(version=0, inputs=[max_input, max_input], outputs=[small_output])
+
+    client.send_raw_apdu(InsType.SIGN_TX, p1=P1.P1_START, p2=P2.P2_MORE, data=tx.serialize_first_chunk())
+    client.send_raw_apdu(InsType.SIGN_TX, p1=P1.P1_OUTPUTS, p2=P2.P2_MORE, data=small_output.serialize())
+    assert client.send_raw_apdu(
+        InsType.SIGN_TX,
+        p1=P1.P1_INPUTS,
+        p2=P2.P2_LAST,
+        data=max_input.serialize() * 2
+    ).status == Errors.SW_TX_PARSING_FAIL
+
+    # Same for the values of the outputs
+    tx = Transaction(version=0, inputs=[max_input], outputs=[max_output, max_output])
+
+    client.send_raw_apdu(InsType.SIGN_TX, p1=P1.P1_START, p2=P2.P2_MORE, data=tx.serialize_first_chunk())
+    client.send_raw_apdu(InsType.SIGN_TX, p1=P1.P1_OUTPUTS, p2=P2.P2_MORE, data=max_output.serialize())
+    assert client.send_raw_apdu(
+        InsType.SIGN_TX,
+        p1=P1.P1_OUTPUTS,
+        p2=P2.P2_MORE,
+        data=max_output.serialize()
+    ).status == Errors.SW_TX_PARSING_FAIL
+
 def test_sign_tx_invalid_io_len(firmware, backend):
     backend.raise_policy = RaisePolicy.RAISE_NOTHING
 
     # Use the app interface instead of raw interface
     client = KaspaCommandSender(backend)
 
-    # Outputs must be len 1 or 2 exactly
+    # Outputs must be from 1 to 4 on Nano S, 32 otherwise
     # Output is 0xFF
     assert client.send_raw_apdu(
         InsType.SIGN_TX,
@@ -475,12 +625,13 @@ def test_sign_tx_invalid_io_len(firmware, backend):
         data=bytes.fromhex("0000FF01")
     ).status == Errors.SW_TX_PARSING_FAIL
 
-    # Output is 3
+    # Output is one more than the device supports
+    max_output_count = 4 if firmware.device == "nanos" else 32
     assert client.send_raw_apdu(
         InsType.SIGN_TX,
         p1=P1.P1_START,
         p2=P2.P2_MORE,
-        data=bytes.fromhex("00000301")
+        data=b"\x00\x00" + (max_output_count + 1).to_bytes(1, "big") + b"\x01"
     ).status == Errors.SW_TX_PARSING_FAIL
 
     # Output is 0
@@ -548,6 +699,141 @@ def test_sign_tx_inconsistent_input_length_and_data(backend):
         data=tx_input.serialize()
     ).status == Errors.SW_TX_PARSING_FAIL
 
+# Inputs sent 5 per APDU are signed as if they were sent one by one
+def test_sign_tx_packed_inputs(firmware, backend, scenario_navigator, test_name):
+    client = KaspaCommandSender(backend)
+    path: str = "m/44'/111111'/0'/0/0"
+
+    rapdu = client.get_public_key(path=path)
+    _, public_key, _, _ = unpack_get_public_key_response(rapdu.data)
+
+    transaction = simple_transaction(public_key, 10)
+
+    with client.sign_tx(transaction=transaction, inputs_per_apdu=MAX_INPUTS_PER_APDU):
+        scenario_navigator.review_approve(test_name="test_sign_tx_simple")
+
+    signatures = read_signatures(client, client.get_async_response().data)
+    assert sorted(signatures) == list(range(10))
+    for input_index, (der_sig, sighash) in signatures.items():
+        assert transaction.get_sighash(input_index) == sighash
+        assert check_signature_validity(public_key, der_sig, sighash)
+
+# The last APDU may hold fewer inputs than the others
+def test_sign_tx_packed_inputs_partial(firmware, backend, scenario_navigator, test_name):
+    client = KaspaCommandSender(backend)
+    path: str = "m/44'/111111'/0'/0/0"
+
+    rapdu = client.get_public_key(path=path)
+    _, public_key, _, _ = unpack_get_public_key_response(rapdu.data)
+
+    # 5 + 5 + 2 inputs
+    transaction = simple_transaction(public_key, 12)
+
+    with client.sign_tx(transaction=transaction, inputs_per_apdu=MAX_INPUTS_PER_APDU):
+        scenario_navigator.review_approve(test_name="test_sign_tx_simple")
+
+    signatures = read_signatures(client, client.get_async_response().data)
+    assert sorted(signatures) == list(range(12))
+    for input_index, (der_sig, sighash) in signatures.items():
+        assert transaction.get_sighash(input_index) == sighash
+        assert check_signature_validity(public_key, der_sig, sighash)
+
+# A run of inputs must be a whole number of 46 bytes records
+def test_sign_tx_packed_inputs_bad_length(backend):
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    # Use the app interface instead of raw interface
+    client = KaspaCommandSender(backend)
+
+    tx_input = TransactionInput(
+        value=1100000,
+        tx_id="40b022362f1a303518e2b49f86f87a317c87b514ca0f3d08ad2e7cf49d08cc70",
+        address_type=0,
+        address_index=0,
+        index=0,
+        public_key=None
+    )
+    record = tx_input.serialize()
+    assert len(record) == 46
+
+    # Initialize, setting input length to 3
+    client.send_raw_apdu(InsType.SIGN_TX, p1=P1.P1_START, p2=P2.P2_MORE, data=bytes.fromhex("00000103"))
+
+    for data in [record[:45], record + record[:1], record * 2 + record[:10]]:
+        assert client.send_raw_apdu(
+            InsType.SIGN_TX,
+            p1=P1.P1_INPUTS,
+            p2=P2.P2_MORE,
+            data=data
+        ).status == Errors.SW_TX_PARSING_FAIL
+
+# An APDU can't hold more inputs than are left to be sent
+def test_sign_tx_packed_inputs_more_than_announced(backend):
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    # Use the app interface instead of raw interface
+    client = KaspaCommandSender(backend)
+
+    tx_input = TransactionInput(
+        value=1100000,
+        tx_id="40b022362f1a303518e2b49f86f87a317c87b514ca0f3d08ad2e7cf49d08cc70",
+        address_type=0,
+        address_index=0,
+        index=0,
+        public_key=None
+    )
+
+    # Initialize, setting input length to 3
+    client.send_raw_apdu(InsType.SIGN_TX, p1=P1.P1_START, p2=P2.P2_MORE, data=bytes.fromhex("00000103"))
+
+    assert client.send_raw_apdu(
+        InsType.SIGN_TX,
+        p1=P1.P1_INPUTS,
+        p2=P2.P2_MORE,
+        data=tx_input.serialize() * 4
+    ).status == Errors.SW_TX_PARSING_FAIL
+
+    assert client.send_raw_apdu(
+        InsType.SIGN_TX,
+        p1=P1.P1_INPUTS,
+        p2=P2.P2_MORE,
+        data=tx_input.serialize() * 2
+    ).status == 0x9000
+
+    # Only one input is left
+    assert client.send_raw_apdu(
+        InsType.SIGN_TX,
+        p1=P1.P1_INPUTS,
+        p2=P2.P2_MORE,
+        data=tx_input.serialize() * 2
+    ).status == Errors.SW_TX_PARSING_FAIL
+
+def test_sign_tx_eagerly_too_many_inputs(firmware, backend):
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    client = KaspaCommandSender(backend)
+
+    # Signatures signed eagerly take the place of the inputs, which only
+    # has room for 11 of them on Nano S and 96 otherwise
+    max_eager_count = 11 if firmware.device == "nanos" else 96
+
+    header = b"".join([
+        (0).to_bytes(2, "big"),
+        (1).to_bytes(1, "big"),
+        (max_eager_count + 1).to_bytes(1, "big"),
+        (0).to_bytes(1, "big"),
+        (0).to_bytes(4, "big"),
+        (0x80000000).to_bytes(4, "big"),
+        (0x01).to_bytes(1, "big")
+    ])
+
+    assert client.send_raw_apdu(
+        InsType.SIGN_TX,
+        p1=P1.P1_START,
+        p2=P2.P2_MORE,
+        data=header
+    ).status == Errors.SW_TX_PARSING_FAIL
+
 def test_sign_tx_inconsistent_output_length_and_data(backend):
     backend.raise_policy = RaisePolicy.RAISE_NOTHING
 
@@ -631,6 +917,418 @@ def test_sign_tx_max(firmware, backend, scenario_navigator, test_name):
         assert transaction.get_sighash(input_index) == sighash
         assert check_signature_validity(public_key, der_sig, sighash)
 
+    # Every input has the same path, so its key is derived once, during the
+    # review, and each signature reuses it
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    rapdu = client.get_key_derivation_stats()
+    if rapdu.status == Errors.SW_INS_NOT_SUPPORTED:
+        pytest.skip("the key derivation counters need HAVE_DEBUG_APDU")
+
+    assert rapdu.status == 0x9000
+    assert unpack_key_derivation_stats_response(rapdu.data) == (1, max_input_count)
+
+# Each input is signed with the key of its own path, as derived by the SDK.
+# Only the inputs differ from test_sign_tx_simple, so the review is the same.
+def test_sign_tx_derivation_paths(firmware, backend, scenario_navigator, test_name):
+    client = KaspaCommandSender(backend)
+    account = 0x8000038f
+
+    # Both sides of the hardened boundary of the address index
+    paths = [(0, 0), (1, 0), (0, 7), (1, 0x7FFFFFFF), (0, 0x80000000), (1, 0x80000005)]
+
+    inputs = []
+    public_keys = []
+    for input_index, (address_type, address_index) in enumerate(paths):
+        if address_index & 0x80000000:
+            address_level = f"{address_index & 0x7FFFFFFF}'"
+        else:
+            address_level = f"{address_index}"
+        path = f"m/44'/111111'/{account & 0x7FFFFFFF}'/{address_type}/{address_level}"
+        ref_public_key, _ = calculate_public_key_and_chaincode(CurveChoice.Secp256k1, path=path)
+        public_key = bytes.fromhex(ref_public_key)
+        public_keys.append(public_key)
+
+        inputs.append(TransactionInput(
+            value=1100000 // len(paths) + (1100000 % len(paths) if input_index == 0 else 0),
+            tx_id="40b022362f1a303518e2b49f86f87a317c87b514ca0f3d08ad2e7cf49d08cc" + input_index.to_bytes(1, 'big').hex(),
+            address_type=address_type,
+            address_index=address_index,
+            index=0,
+            public_key=public_key[1:33]
+        ))
+
+    transaction = Transaction(
+        version=0,
+        account=account,
+        inputs=inputs,
+        outputs=[
+            TransactionOutput(
+                value=1090000,
+                script_public_key="2011a7215f668e921013eb7aac9b7e64b9ec6e757c1b648e89388c919f676aa88cac"
+            )
+        ]
+    )
+
+    with client.sign_tx(transaction=transaction):
+        scenario_navigator.review_approve(test_name="test_sign_tx_simple")
+
+    signed = set()
+    response = client.get_async_response().data
+    while True:
+        has_more, input_index, _, der_sig, _, sighash = unpack_sign_tx_response(response)
+        assert transaction.get_sighash(input_index) == sighash
+        assert check_signature_validity(public_keys[input_index], der_sig, sighash)
+        signed.add(input_index)
+
+        if has_more == 0:
+            break
+        response = client.get_next_signature().data
+
+    assert signed == set(range(len(paths)))
+
+# The signatures left after the approval are fetched several per APDU,
+# with (flags 0) or without (flags 1) their sighash
+@pytest.mark.parametrize("with_sighash", [True, False])
+def test_sign_tx_next_signatures(firmware, backend, scenario_navigator, test_name, with_sighash):
+    client = KaspaCommandSender(backend)
+    path: str = "m/44'/111111'/0'/0/0"
+
+    rapdu = client.get_public_key(path=path)
+    _, public_key, _, _ = unpack_get_public_key_response(rapdu.data)
+
+    input_count = 8
+    transaction = simple_transaction(public_key, input_count)
+
+    with client.sign_tx(transaction=transaction):
+        scenario_navigator.review_approve(test_name="test_sign_tx_simple")
+
+    # The first signature comes with the approval
+    has_more, input_index, _, der_sig, _, sighash = unpack_sign_tx_response(client.get_async_response().data)
+    assert has_more == input_count - 1
+    assert transaction.get_sighash(input_index) == sighash
+    assert check_signature_validity(public_key, der_sig, sighash)
+    signed = {input_index}
+
+    # input_index (1) || der_sig_len (1) || der_sig (64) [|| sighash_len (1) || sighash (32)]
+    record_len = 1 + 1 + 64 + (1 + 32 if with_sighash else 0)
+    # As many as fit in IO_APDU_BUFFER_SIZE (260) less the status word and the header
+    per_apdu = (260 - 2 - 2) // record_len
+
+    while has_more > 0:
+        response = client.get_next_signatures(with_sighash=with_sighash).data
+        expected_count = min(has_more, per_apdu)
+
+        assert len(response) == 2 + expected_count * record_len
+        for record in range(expected_count):
+            offset = 2 + record * record_len
+            assert response[offset + 1] == 64
+            if with_sighash:
+                assert response[offset + 2 + 64] == 32
+
+        next_has_more, records = unpack_sign_tx_batch_response(response, with_sighash)
+        assert len(records) == expected_count
+        assert next_has_more == has_more - expected_count
+        has_more = next_has_more
+
+        for input_index, der_sig, sighash in records:
+            assert input_index not in signed
+            signed.add(input_index)
+
+            expected_sighash = transaction.get_sighash(input_index)
+            if with_sighash:
+                assert sighash == expected_sighash
+            assert check_signature_validity(public_key, der_sig, expected_sighash)
+
+    assert signed == set(range(input_count))
+
+    # Nothing is left to sign
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    assert client.get_next_signatures(with_sighash=with_sighash).status == Errors.SW_BAD_STATE
+
+# Streamed inputs are not kept by the device, so there can be more of them
+# than MAX_INPUT_COUNT. Each one is sent again with its commitment to be
+# signed, in any order, and only once.
+def test_sign_tx_streamed(firmware, backend, scenario_navigator, test_name):
+    client = KaspaCommandSender(backend)
+    path: str = "m/44'/111111'/0'/0/0"
+
+    rapdu = client.get_public_key(path=path)
+    _, public_key, _, _ = unpack_get_public_key_response(rapdu.data)
+
+    max_input_count = 15 if firmware.device == "nanos" else 128
+    input_count = max_input_count + 2
+    transaction = simple_transaction(public_key, input_count)
+
+    with client.sign_tx_streamed(transaction=transaction):
+        scenario_navigator.review_approve(test_name="test_sign_tx_simple")
+
+    # The commitments of the last APDU of inputs come with the approval
+    commitments = client.input_commitments + split_message(client.get_async_response().data, INPUT_COMMITMENT_LEN)
+    assert len(commitments) == input_count
+
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    # Odd indexes going down, then even ones going up
+    order = [i for i in reversed(range(input_count)) if i % 2 == 1] + [i for i in range(input_count) if i % 2 == 0]
+    assert sorted(order) == list(range(input_count))
+
+    first = order[0]
+    other = order[1]
+    txinput = transaction.inputs[first]
+
+    # An input that is not the one streamed and reviewed
+    tampered = TransactionInput(
+        value=txinput.value + 1,
+        tx_id=txinput.tx_id.hex(),
+        address_type=txinput.address_type,
+        address_index=txinput.address_index,
+        index=txinput.index,
+        public_key=txinput.public_key
+    )
+    assert client.sign_streamed_input(tampered, first, commitments[first]).status == Errors.SW_INPUT_COMMITMENT_FAIL
+    # The commitment covers the index of the input
+    assert client.sign_streamed_input(txinput, other, commitments[first]).status == Errors.SW_INPUT_COMMITMENT_FAIL
+    # and the input itself
+    assert client.sign_streamed_input(txinput, first, commitments[other]).status == Errors.SW_INPUT_COMMITMENT_FAIL
+
+    for position, input_index in enumerate(order):
+        rapdu = client.sign_streamed_input(transaction.inputs[input_index], input_index, commitments[input_index])
+        assert rapdu.status == 0x9000
+
+        signed_index, _, der_sig, _, sighash = unpack_sign_streamed_input_response(rapdu.data)
+        assert signed_index == input_index
+        assert transaction.get_sighash(input_index) == sighash
+        assert check_signature_validity(public_key, der_sig, sighash)
+
+        if position == 0:
+            # Each input is signed once
+            rapdu = client.sign_streamed_input(transaction.inputs[input_index], input_index, commitments[input_index])
+            assert rapdu.status == Errors.SW_BAD_STATE
+
+    # Once every input is signed the transaction is over
+    assert client.sign_streamed_input(transaction.inputs[first], first, commitments[first]).status == Errors.SW_BAD_STATE
+
+# When signing eagerly, every input is signed on approval and only the
+# signatures are sent back, several per APDU and without their sighash
+def test_sign_tx_eagerly(firmware, backend, scenario_navigator, test_name):
+    client = KaspaCommandSender(backend)
+    account = 0x80000000
+
+    max_eager_count = 11 if firmware.device == "nanos" else 96
+
+    # Inputs are spread over 10 paths, in no particular order
+    public_keys = {}
+    inputs = []
+    for input_index in range(max_eager_count):
+        address_type = input_index % 2
+        address_index = (input_index * 3) % 5
+        if (address_type, address_index) not in public_keys:
+            path = f"m/44'/111111'/{account & 0x7FFFFFFF}'/{address_type}/{address_index}"
+            ref_public_key, _ = calculate_public_key_and_chaincode(CurveChoice.Secp256k1, path=path)
+            public_keys[(address_type, address_index)] = bytes.fromhex(ref_public_key)
+        public_key = public_keys[(address_type, address_index)]
+
+        inputs.append(TransactionInput(
+            value=1100000 // max_eager_count + (1100000 % max_eager_count if input_index == 0 else 0),
+            tx_id="40b022362f1a303518e2b49f86f87a317c87b514ca0f3d08ad2e7cf49d08cc" + input_index.to_bytes(1, 'big').hex(),
+            address_type=address_type,
+            address_index=address_index,
+            index=0,
+            public_key=public_key[1:33]
+        ))
+
+    transaction = Transaction(
+        version=0,
+        account=account,
+        inputs=inputs,
+        outputs=[
+            TransactionOutput(
+                value=1090000,
+                script_public_key="2011a7215f668e921013eb7aac9b7e64b9ec6e757c1b648e89388c919f676aa88cac"
+            )
+        ]
+    )
+
+    # Same review as test_sign_tx_simple
+    with client.sign_tx(transaction=transaction, sign_eagerly=True):
+        scenario_navigator.review_approve(test_name="test_sign_tx_simple")
+
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+
+    signed = set()
+    response = client.get_async_response().data
+    while True:
+        has_more, records = unpack_sign_tx_batch_response(response, with_sighash=False)
+        assert len(records) > 0
+        for input_index, der_sig, _ in records:
+            assert input_index not in signed
+            signed.add(input_index)
+
+            txinput = transaction.inputs[input_index]
+            public_key = public_keys[(txinput.address_type, txinput.address_index)]
+            assert check_signature_validity(public_key, der_sig, transaction.get_sighash(input_index))
+
+        assert has_more == max_eager_count - len(signed)
+        if has_more == 0:
+            break
+
+        # The sighashes were not kept, and signatures only come as a table
+        assert client.get_next_signature().status == Errors.SW_BAD_STATE
+        assert client.get_next_signatures(with_sighash=True).status == Errors.SW_BAD_STATE
+
+        rapdu = client.get_next_signatures(with_sighash=False)
+        assert rapdu.status == 0x9000
+        response = rapdu.data
+
+    assert signed == set(range(max_eager_count))
+
+    # Nothing is left to fetch
+    assert client.get_next_signatures(with_sighash=False).status == Errors.SW_BAD_STATE
+
+# Several recipients are reviewed one page each, the change is not shown
+def test_sign_tx_recipients(firmware, backend, navigator, scenario_navigator, test_name):
+    client = KaspaCommandSender(backend)
+    path: str = "m/44'/111111'/0'/0/0"
+
+    rapdu = client.get_public_key(path=path)
+    _, public_key, _, _ = unpack_get_public_key_response(rapdu.data)
+
+    change_script_public_key = b"".join([
+        0x20.to_bytes(1, 'big'),
+        public_key[1:33],
+        0xac.to_bytes(1, 'big')]).hex()
+
+    transaction = Transaction(
+        version=0,
+        inputs=[
+            TransactionInput(
+                value=1100000,
+                tx_id="40b022362f1a303518e2b49f86f87a317c87b514ca0f3d08ad2e7cf49d08cc70",
+                address_type=0,
+                address_index=0,
+                index=0,
+                public_key=public_key[1:33]
+            )
+        ],
+        outputs=[
+            TransactionOutput(value=100000, script_public_key=recipient_script(1)),
+            TransactionOutput(value=200000, script_public_key=recipient_script(2)),
+            TransactionOutput(value=300000, script_public_key=recipient_script(3)),
+            TransactionOutput(value=480000, script_public_key=change_script_public_key)
+        ]
+    )
+
+    with client.sign_tx(transaction=transaction):
+        review_recipients_approve(firmware, navigator, scenario_navigator, test_name, 3)
+
+    response = client.get_async_response().data
+    _, _, _, der_sig, _, sighash = unpack_sign_tx_response(response)
+    assert transaction.get_sighash(0) == sighash
+    assert check_signature_validity(public_key, der_sig, sighash)
+
+# As many outputs as the device takes, all but the change being reviewed
+def test_sign_tx_max_outputs(firmware, backend, navigator, scenario_navigator, test_name):
+    client = KaspaCommandSender(backend)
+    path: str = "m/44'/111111'/0'/0/0"
+
+    rapdu = client.get_public_key(path=path)
+    _, public_key, _, _ = unpack_get_public_key_response(rapdu.data)
+
+    max_output_count = 4 if firmware.device == "nanos" else 32
+    recipients = max_output_count - 1
+
+    change_script_public_key = b"".join([
+        0x20.to_bytes(1, 'big'),
+        public_key[1:33],
+        0xac.to_bytes(1, 'big')]).hex()
+
+    outputs = [TransactionOutput(value=1000 * (recipient + 1), script_public_key=recipient_script(recipient))
+               for recipient in range(recipients)]
+    change = 1100000 - 10000 - sum(output.value for output in outputs)
+    outputs.append(TransactionOutput(value=change, script_public_key=change_script_public_key))
+
+    transaction = Transaction(
+        version=0,
+        inputs=[
+            TransactionInput(
+                value=1100000,
+                tx_id="40b022362f1a303518e2b49f86f87a317c87b514ca0f3d08ad2e7cf49d08cc70",
+                address_type=0,
+                address_index=0,
+                index=0,
+                public_key=public_key[1:33]
+            )
+        ],
+        outputs=outputs
+    )
+
+    with client.sign_tx(transaction=transaction):
+        review_recipients_approve(firmware, navigator, scenario_navigator, test_name, recipients)
+
+    response = client.get_async_response().data
+    _, _, _, der_sig, _, sighash = unpack_sign_tx_response(response)
+    assert transaction.get_sighash(0) == sighash
+    assert check_signature_validity(public_key, der_sig, sighash)
+
+# An output that can't be formatted aborts the review: the transaction is
+# dropped and the next one is signed as usual
+def test_sign_tx_output_format_fail(firmware, backend, scenario_navigator, test_name):
+    client = KaspaCommandSender(backend)
+    path: str = "m/44'/111111'/0'/0/0"
+
+    rapdu = client.get_public_key(path=path)
+    _, public_key, _, _ = unpack_get_public_key_response(rapdu.data)
+
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    rapdu = client.fail_next_output_format()
+    if rapdu.status == Errors.SW_INS_NOT_SUPPORTED:
+        pytest.skip("failing the output format needs HAVE_DEBUG_APDU")
+    assert rapdu.status == 0x9000
+
+    transaction = simple_transaction(public_key, 1)
+
+    # The output is formatted before anything is shown
+    with client.sign_tx(transaction=transaction):
+        pass
+    assert client.get_async_response().status == Errors.SW_DISPLAY_AMOUNT_FAIL
+
+    # Nothing is left to sign
+    assert client.get_next_signature().status == Errors.SW_BAD_STATE
+
+    # Nano devices also format the first of several recipients before
+    # showing anything
+    if firmware.device.startswith("nano"):
+        assert client.fail_next_output_format().status == 0x9000
+
+        change_script_public_key = b"".join([
+            0x20.to_bytes(1, 'big'),
+            public_key[1:33],
+            0xac.to_bytes(1, 'big')]).hex()
+
+        recipients = Transaction(
+            version=0,
+            inputs=transaction.inputs,
+            outputs=[
+                TransactionOutput(value=500000, script_public_key=recipient_script(1)),
+                TransactionOutput(value=500000, script_public_key=recipient_script(2)),
+                TransactionOutput(value=90000, script_public_key=change_script_public_key)
+            ]
+        )
+        with client.sign_tx(transaction=recipients):
+            pass
+        assert client.get_async_response().status == Errors.SW_DISPLAY_AMOUNT_FAIL
+        assert client.get_next_signature().status == Errors.SW_BAD_STATE
+
+    backend.raise_policy = RaisePolicy.RAISE_ALL_BUT_0x9000
+
+    with client.sign_tx(transaction=transaction):
+        scenario_navigator.review_approve(test_name="test_sign_tx_simple")
+
+    response = client.get_async_response().data
+    _, _, _, der_sig, _, sighash = unpack_sign_tx_response(response)
+    assert transaction.get_sighash(0) == sighash
+    assert check_signature_validity(public_key, der_sig, sighash)
+
 # Transaction signature refused test
 # The test will ask for a transaction signature that will be refused on screen
 def test_sign_tx_refused(firmware, backend, scenario_navigator, test_name):
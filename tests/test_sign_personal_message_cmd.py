@@ -119,6 +119,59 @@ def test_sign_message_too_long(firmware, backend, navigator, test_name):
 
     assert last_response.status == Errors.SW_MESSAGE_TOO_LONG
 
+# A message too long for one APDU is sent in chunks. Only its start is
+# previewed, followed by its length and hash.
+def test_sign_message_chunked(firmware, backend, scenario_navigator, test_name):
+    client = KaspaCommandSender(backend)
+    path: str = "m/44'/111111'/0'/1/5"
+
+    rapdu = client.get_public_key(path=path)
+    _, public_key, _, _ = unpack_get_public_key_response(rapdu.data)
+
+    address_type = 1
+    address_index = 5
+    sentence = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore. "
+    message = (sentence * 50)[:4500]
+
+    message_data = PersonalMessage(message, address_type, address_index)
+    assert len(message_data.message) == 4500
+
+    with client.sign_message_chunked(message_data=message_data):
+        scenario_navigator.review_approve()
+
+    response = client.get_async_response().data
+    _, der_sig, _, message_hash = unpack_sign_message_response(response)
+
+    assert message_hash == message_data.to_hash()
+    assert check_signature_validity(public_key, der_sig, message_hash)
+
+# Chunks of a message sent out of order or that don't add up to its length are rejected
+def test_sign_message_chunked_invalid(firmware, backend, navigator, test_name):
+    backend.raise_policy = RaisePolicy.RAISE_NOTHING
+    client = KaspaCommandSender(backend)
+
+    message_data = PersonalMessage("Hello Kaspa!", 1, 4)
+    start = message_data.serialize_chunked_start()
+
+    # No chunked message was started
+    response = client.send_raw_apdu(InsType.SIGN_MESSAGE, p1=P1.P1_MESSAGE_CHUNK, p2=P2.P2_MORE, data=b"Hello")
+    assert response.status == Errors.SW_BAD_STATE
+
+    # More bytes than announced
+    assert client.send_raw_apdu(InsType.SIGN_MESSAGE, p1=P1.P1_MESSAGE_START_CHUNKED, p2=P2.P2_MORE, data=start).status == 0x9000
+    response = client.send_raw_apdu(InsType.SIGN_MESSAGE, p1=P1.P1_MESSAGE_CHUNK, p2=P2.P2_LAST, data=message_data.message * 2)
+    assert response.status == Errors.SW_MESSAGE_TOO_LONG
+
+    # Last chunk sent before the message is complete
+    assert client.send_raw_apdu(InsType.SIGN_MESSAGE, p1=P1.P1_MESSAGE_START_CHUNKED, p2=P2.P2_MORE, data=start).status == 0x9000
+    response = client.send_raw_apdu(InsType.SIGN_MESSAGE, p1=P1.P1_MESSAGE_CHUNK, p2=P2.P2_LAST, data=message_data.message[:5])
+    assert response.status == Errors.SW_MESSAGE_TOO_SHORT
+
+    # Empty message
+    empty = PersonalMessage("", 1, 4).serialize_chunked_start()
+    response = client.send_raw_apdu(InsType.SIGN_MESSAGE, p1=P1.P1_MESSAGE_START_CHUNKED, p2=P2.P2_MORE, data=empty)
+    assert response.status == Errors.SW_MESSAGE_TOO_SHORT
+
 def test_sign_message_refused(firmware, backend, scenario_navigator, test_name):
     # Use the app interface instead of raw interface
     client = KaspaCommandSender(backend)
@@ -0,0 +1,97 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "./import/blake2b.h"
+
+#ifdef BLAKE2B_UNROLLED
+#define KERNEL_NAME "unrolled"
+#else
+#define KERNEL_NAME "reference"
+#endif
+
+#define BENCH_MIN_BYTES (64 * 1024 * 1024)
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+// Cycle counter where one is readily available, 0 otherwise
+static uint64_t now_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static uint8_t message[4096];
+
+int main() {
+    size_t lens[] = {1, 32, sizeof(message)};
+    uint8_t out[32] = {0};
+    blake2b_state S;
+
+    for (size_t i = 0; i < sizeof(message); i++) {
+        message[i] = (uint8_t) i;
+    }
+
+    printf("kernel: %s\n", KERNEL_NAME);
+    printf("%8s %12s %12s %12s\n", "bytes", "ns/hash", "ns/byte", "cycles/byte");
+
+    for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+        size_t len = lens[l];
+        size_t rounds = BENCH_MIN_BYTES / (len < 128 ? 128 : len);
+
+        uint64_t start_ns = now_ns();
+        uint64_t start_cycles = now_cycles();
+        for (size_t r = 0; r < rounds; r++) {
+            blake2b_init(&S, sizeof(out));
+            blake2b_update(&S, message, len);
+            blake2b_final(&S, out, sizeof(out));
+        }
+        uint64_t elapsed_cycles = now_cycles() - start_cycles;
+        uint64_t elapsed_ns = now_ns() - start_ns;
+
+        double bytes = (double) rounds * (double) len;
+        printf("%8zu %12.1f %12.2f %12.2f\n",
+               len,
+               (double) elapsed_ns / (double) rounds,
+               (double) elapsed_ns / bytes,
+               (double) elapsed_cycles / bytes);
+    }
+
+    // Keep the digest observable so the loop is not optimized away
+    return out[0] == 0xff && out[1] == 0xff ? 1 : 0;
+}
@@ -0,0 +1,110 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "sighash.h"
+#include "./transaction/types.h"
+#include "types.h"
+
+/* Start hacks */
+void os_longjmp(unsigned int exception) {}
+
+global_ctx_t G_context;
+
+/* End hacks */
+
+#define BENCH_ROUNDS 20
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static void fill_transaction(transaction_t *tx, size_t input_len) {
+    memset(tx, 0, sizeof(*tx));
+
+    tx->version = 0;
+    tx->tx_input_len = input_len;
+    tx->tx_output_len = 2;
+
+    for (size_t i = 0; i < input_len; i++) {
+        memset(tx->tx_inputs[i].tx_id, (int) i, 32);
+        tx->tx_inputs[i].index = (uint8_t) i;
+        tx->tx_inputs[i].value = 100000 + i;
+    }
+
+    for (size_t o = 0; o < tx->tx_output_len; o++) {
+        uint8_t *script = tx->tx_scripts.data + tx->tx_scripts.len;
+
+        tx->tx_output_values[o] = 1000;
+        tx->tx_output_script_offsets[o] = tx->tx_scripts.len;
+        tx->tx_output_script_lens[o] = 34;
+        script[0] = 0x20;
+        memset(script + 1, 0x11 * (o + 1), 32);
+        script[33] = OP_CHECKSIG;
+        tx->tx_scripts.len += 34;
+    }
+}
+
+static sighash_cache_t cache;
+static uint8_t public_keys[MAX_INPUT_COUNT][32];
+static uint8_t sighashes[MAX_INPUT_COUNT][32];
+
+// The transaction-wide digests are computed once then every input's
+// sighash is computed from them
+static bool sign_all_inputs(transaction_t *tx) {
+    return calc_sighash_all(tx, &cache, (const uint8_t(*)[32]) public_keys, sighashes);
+}
+
+int main() {
+    static transaction_t tx;
+
+    printf("%8s %14s %14s\n", "inputs", "total (us)", "per input (us)");
+
+    for (size_t input_len = 1; input_len <= MAX_INPUT_COUNT; input_len *= 2) {
+        fill_transaction(&tx, input_len);
+
+        uint64_t start = now_ns();
+        for (int round = 0; round < BENCH_ROUNDS; round++) {
+            if (!sign_all_inputs(&tx)) {
+                fprintf(stderr, "sighash failed for %zu inputs\n", input_len);
+                return 1;
+            }
+        }
+        uint64_t elapsed = (now_ns() - start) / BENCH_ROUNDS;
+
+        printf("%8zu %14.1f %14.2f\n",
+               input_len,
+               (double) elapsed / 1000.0,
+               (double) elapsed / 1000.0 / (double) input_len);
+    }
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "buffer.h"
+#include "./transaction/deserialize.h"
+#include "./transaction/types.h"
+
+#define BENCH_RECORDS (4 * 1024 * 1024)
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+// As many records as a P1_INPUTS APDU holds
+static uint8_t records[MAX_INPUTS_PER_APDU][SERIALIZED_INPUT_LEN];
+static transaction_input_t inputs[MAX_INPUTS_PER_APDU];
+
+static bool parse_reference(void) {
+    for (size_t i = 0; i < MAX_INPUTS_PER_APDU; i++) {
+        buffer_t buf = {.ptr = records[i], .size = SERIALIZED_INPUT_LEN, .offset = 0};
+        if (transaction_input_deserialize(&buf, &inputs[i]) != PARSING_OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parse_record(void) {
+    for (size_t i = 0; i < MAX_INPUTS_PER_APDU; i++) {
+        if (transaction_input_deserialize_record(records[i], SERIALIZED_INPUT_LEN, &inputs[i]) !=
+            PARSING_OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int run(const char *name, bool (*parse)(void)) {
+    size_t rounds = BENCH_RECORDS / MAX_INPUTS_PER_APDU;
+    uint64_t checksum = 0;
+
+    uint64_t start = now_ns();
+    for (size_t r = 0; r < rounds; r++) {
+        if (!parse()) {
+            fprintf(stderr, "%s: parsing failed\n", name);
+            return 1;
+        }
+        // Keeps the parsed inputs alive
+        checksum += inputs[r % MAX_INPUTS_PER_APDU].value;
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    double records_parsed = (double) (rounds * MAX_INPUTS_PER_APDU);
+    printf("%10s %14.1f %14.0f %18llu\n",
+           name,
+           (double) elapsed / records_parsed,
+           records_parsed * 1e9 / (double) elapsed,
+           (unsigned long long) checksum);
+
+    return 0;
+}
+
+int main() {
+    for (size_t i = 0; i < MAX_INPUTS_PER_APDU; i++) {
+        for (size_t b = 0; b < SERIALIZED_INPUT_LEN; b++) {
+            records[i][b] = (uint8_t) (i * SERIALIZED_INPUT_LEN + b);
+        }
+    }
+
+    printf("%10s %14s %14s %18s\n", "parser", "ns/record", "records/s", "checksum");
+
+    if (run("reference", parse_reference) != 0 || run("record", parse_record) != 0) {
+        return 1;
+    }
+
+    return 0;
+}
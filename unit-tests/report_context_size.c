@@ -0,0 +1,84 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stddef.h>
+#include <stdio.h>
+
+// The tests are built with the limits of the larger targets, report the
+// Nano S ones from the Makefile instead
+#ifdef REPORT_TARGET_NANOS
+#undef MAX_INPUT_COUNT
+#define MAX_INPUT_COUNT 15
+#undef MAX_OUTPUT_COUNT
+#define MAX_OUTPUT_COUNT 4
+#undef MAX_MESSAGE_LEN
+#define MAX_MESSAGE_LEN 120
+#define REPORT_TARGET "Nano S"
+// Host sizes of transaction_ctx_t and G_context with app-kaspa 1.0.3, before
+// the sighash cache, the script arena and the precomputed keys. There were 2
+// outputs at most then, on every target
+#define BASELINE_TRANSACTION_CTX 1184
+#define BASELINE_G_CONTEXT       1224
+#else
+#define REPORT_TARGET "Nano S+, Nano X, Stax, Flex"
+#define BASELINE_TRANSACTION_CTX 8416
+#define BASELINE_G_CONTEXT       8456
+#endif
+
+#include "./transaction/types.h"
+#include "types.h"
+
+#define REPORT(name, size) printf("%-24s %6zu\n", name, (size_t) (size))
+#define REPORT_DELTA(name, size, baseline)    \
+    printf("%-24s %6zu %+6ld from %d\n",      \
+           name,                              \
+           (size_t) (size),                   \
+           (long) (size) - (long) (baseline), \
+           baseline)
+
+// Sizes are those of the host build: pointers and size_t take 8 bytes here
+// and 4 on the device, so the device context is a little smaller
+int main() {
+    transaction_t tx;
+
+    printf("%s: MAX_INPUT_COUNT %d, MAX_OUTPUT_COUNT %d, MAX_MESSAGE_LEN %d\n",
+           REPORT_TARGET,
+           MAX_INPUT_COUNT,
+           MAX_OUTPUT_COUNT,
+           MAX_MESSAGE_LEN);
+
+    REPORT("transaction_input_t", sizeof(transaction_input_t));
+    REPORT("inputs", sizeof(tx.tx_inputs));
+    REPORT("eager signatures", sizeof(tx.tx_signatures));
+    REPORT("outputs",
+           sizeof(tx.tx_output_values) + sizeof(tx.tx_output_script_offsets) +
+               sizeof(tx.tx_output_script_lens));
+    REPORT("output scripts", sizeof(tx.tx_scripts));
+    REPORT("transaction_t", sizeof(transaction_t));
+    REPORT_DELTA("transaction_ctx_t", sizeof(transaction_ctx_t), BASELINE_TRANSACTION_CTX);
+    REPORT("message_sign_ctx_t", sizeof(message_sign_ctx_t));
+    REPORT("pubkey_ctx_t", sizeof(pubkey_ctx_t));
+    REPORT_DELTA("G_context", sizeof(global_ctx_t), BASELINE_G_CONTEXT);
+
+    return 0;
+}
@@ -0,0 +1,262 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "context.h"
+#include "globals.h"
+#include "transaction/deserialize.h"
+
+/* Start hacks */
+global_ctx_t G_context;
+/* End hacks */
+
+// clang-format off
+static uint8_t schnorr_output[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x86, 0xa0,
+    0x20,
+    0xe1, 0x19, 0xd5, 0x35, 0x14, 0xc1, 0xb0, 0xe2,
+    0xef, 0xce, 0x7a, 0x89, 0xe3, 0xd1, 0xd5, 0xd6,
+    0xcd, 0x73, 0x58, 0x2e, 0xa2, 0x06, 0x87, 0x64,
+    0x1c, 0x8f, 0xdc, 0xcb, 0x60, 0x60, 0xa9, 0xad,
+    OP_CHECKSIG
+};
+// clang-format on
+
+static size_t inputs_area_len(void) {
+    transaction_t *tx = &G_context.tx_info.transaction;
+    return sizeof(tx->tx_signatures) > sizeof(tx->tx_inputs) ? sizeof(tx->tx_signatures)
+                                                             : sizeof(tx->tx_inputs);
+}
+
+// Fails with the offset of the first stale byte, if any
+static void assert_context_wiped(void) {
+    const uint8_t *bytes = (const uint8_t *) &G_context;
+    size_t stale = 0;
+
+    while (stale < sizeof(G_context) && bytes[stale] == 0) {
+        stale++;
+    }
+
+    assert_int_equal(stale, sizeof(G_context));
+}
+
+static void fill_outside_union(void) {
+    G_context.state = STATE_APPROVED;
+    G_context.bip32_path_len = KASPA_MAX_BIP32_PATH_LEN;
+    memset(G_context.bip32_path, 0xA5, sizeof(G_context.bip32_path));
+}
+
+// Every byte of the transaction context written, but for the script arena
+// and the input storage
+static void fill_transaction_header(void) {
+    transaction_t *tx = &G_context.tx_info.transaction;
+
+    G_context.req_type = CONFIRM_TRANSACTION;
+    fill_outside_union();
+
+    memset(&G_context.tx_info, 0xA5, sizeof(G_context.tx_info));
+    memset(&tx->tx_scripts, 0, sizeof(tx->tx_scripts));
+    memset(tx->tx_inputs, 0, inputs_area_len());
+    G_context.tx_info.inputs_high_water = 0;
+}
+
+static void add_inputs(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        context_mark_inputs((i + 1) * sizeof(transaction_input_t));
+        memset(&G_context.tx_info.transaction.tx_inputs[i], 0x5A, sizeof(transaction_input_t));
+    }
+}
+
+static void add_outputs(size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        transaction_output_t txout = {0};
+        buffer_t buf = {.ptr = schnorr_output, .size = sizeof(schnorr_output), .offset = 0};
+
+        assert_int_equal(
+            transaction_output_deserialize(&buf, &txout, &G_context.tx_info.transaction.tx_scripts),
+            PARSING_OK);
+    }
+}
+
+static void test_context_reset_public_key(void **state) {
+    (void) state;
+
+    memset(&G_context, 0, sizeof(G_context));
+
+    context_reset();
+    G_context.req_type = CONFIRM_ADDRESS;
+    fill_outside_union();
+    memset(&G_context.pk_info, 0xA5, sizeof(G_context.pk_info));
+
+    context_reset();
+    assert_context_wiped();
+}
+
+static void test_context_reset_message(void **state) {
+    (void) state;
+
+    memset(&G_context, 0, sizeof(G_context));
+
+    context_reset();
+    G_context.req_type = CONFIRM_MESSAGE;
+    fill_outside_union();
+    memset(&G_context.msg_info, 0xA5, sizeof(G_context.msg_info));
+
+    context_reset();
+    assert_context_wiped();
+}
+
+static void test_context_reset_transaction(void **state) {
+    (void) state;
+
+    memset(&G_context, 0, sizeof(G_context));
+
+    context_reset();
+    fill_transaction_header();
+    add_inputs(5);
+    add_outputs(3);
+
+    // An output rejected after parsing gives its room in the arena back,
+    // its script is still there
+    G_context.tx_info.transaction.tx_scripts.len -= 34;
+
+    context_reset();
+    assert_context_wiped();
+}
+
+static void test_context_reset_eager_signatures(void **state) {
+    (void) state;
+
+    memset(&G_context, 0, sizeof(G_context));
+
+    context_reset();
+    fill_transaction_header();
+    add_inputs(3);
+
+    // Signing all inputs at once moves them to the end of the area
+    uint8_t *area = (uint8_t *) G_context.tx_info.transaction.tx_signatures;
+    context_mark_inputs(inputs_area_len());
+    memset(area, 0x3C, 3 * MAX_DER_SIG_LEN);
+    memset(area + inputs_area_len() - 3 * sizeof(transaction_input_t),
+           0x5A,
+           3 * sizeof(transaction_input_t));
+
+    context_reset();
+    assert_context_wiped();
+}
+
+static void test_context_reset_streamed_signed_inputs(void **state) {
+    (void) state;
+
+    memset(&G_context, 0, sizeof(G_context));
+
+    context_reset();
+    fill_transaction_header();
+    add_outputs(2);
+
+    // Streamed inputs only leave a bit once signed, input 100 is in byte 12
+    uint8_t *signed_inputs = G_context.tx_info.transaction.tx_signed_inputs;
+    context_mark_inputs(100 / 8 + 1);
+    signed_inputs[100 / 8] |= (uint8_t) (1 << (100 % 8));
+    context_mark_inputs(3 / 8 + 1);
+    signed_inputs[3 / 8] |= (uint8_t) (1 << (3 % 8));
+
+    context_reset();
+    assert_context_wiped();
+}
+
+static void test_context_reset_between_sessions(void **state) {
+    (void) state;
+
+    memset(&G_context, 0, sizeof(G_context));
+
+    // A large transaction, then smaller requests of every kind
+    context_reset();
+    fill_transaction_header();
+    add_inputs(MAX_INPUT_COUNT);
+    add_outputs(MAX_OUTPUT_COUNT);
+
+    context_reset();
+    assert_context_wiped();
+    G_context.req_type = CONFIRM_ADDRESS;
+    memset(&G_context.pk_info, 0xA5, sizeof(G_context.pk_info));
+
+    context_reset();
+    assert_context_wiped();
+    G_context.req_type = CONFIRM_MESSAGE;
+    memset(&G_context.msg_info, 0xA5, sizeof(G_context.msg_info));
+
+    context_reset();
+    assert_context_wiped();
+    fill_transaction_header();
+    add_inputs(1);
+    add_outputs(1);
+
+    context_reset();
+    assert_context_wiped();
+}
+
+static void test_context_reset_is_bounded(void **state) {
+    (void) state;
+
+    memset(&G_context, 0, sizeof(G_context));
+
+    // Storage past what was marked as written is left as is
+    uint8_t *last = (uint8_t *) G_context.tx_info.transaction.tx_inputs + inputs_area_len() - 1;
+    uint8_t *last_script = G_context.tx_info.transaction.tx_scripts.data + SCRIPT_ARENA_LEN - 1;
+
+    context_reset();
+    fill_transaction_header();
+    add_inputs(2);
+    add_outputs(2);
+    *last = 0xEE;
+    *last_script = 0xEE;
+
+    context_reset();
+    assert_int_equal(*last, 0xEE);
+    assert_int_equal(*last_script, 0xEE);
+    assert_int_equal(G_context.tx_info.transaction.tx_inputs[0].value, 0);
+    assert_int_equal(G_context.tx_info.transaction.tx_scripts.data[0], 0);
+
+    memset(&G_context, 0, sizeof(G_context));
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_context_reset_public_key),
+                                       cmocka_unit_test(test_context_reset_message),
+                                       cmocka_unit_test(test_context_reset_transaction),
+                                       cmocka_unit_test(test_context_reset_eager_signatures),
+                                       cmocka_unit_test(test_context_reset_streamed_signed_inputs),
+                                       cmocka_unit_test(test_context_reset_between_sessions),
+                                       cmocka_unit_test(test_context_reset_is_bounded)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
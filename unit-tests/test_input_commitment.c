@@ -0,0 +1,113 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "input_commitment.h"
+
+/* Start hacks */
+void os_longjmp(unsigned int exception) {}
+
+/* End hacks */
+
+static void fill_vector(uint8_t *session_key, uint8_t *input) {
+    for (size_t i = 0; i < INPUT_COMMITMENT_SESSION_LEN; i++) {
+        session_key[i] = (uint8_t) i;
+    }
+
+    for (size_t i = 0; i < 46; i++) {
+        input[i] = (uint8_t) (0xa0 + i);
+    }
+}
+
+static void test_input_commitment_vector(void **state) {
+    (void) state;
+
+    uint8_t session_key[INPUT_COMMITMENT_SESSION_LEN] = {0};
+    uint8_t input[46] = {0};
+    uint8_t out[INPUT_COMMITMENT_LEN] = {0};
+
+    fill_vector(session_key, input);
+
+    assert_true(calc_input_commitment(session_key, 3, input, sizeof(input), out, sizeof(out)));
+
+    uint8_t res[32] = {0xd6, 0xdb, 0x3d, 0x2f, 0xf8, 0x39, 0xb5, 0x61,
+                       0xef, 0x3f, 0x99, 0x92, 0xa4, 0x82, 0x77, 0x99,
+                       0x01, 0x6b, 0x47, 0x4a, 0x9c, 0x31, 0x52, 0x34,
+                       0x91, 0x30, 0x20, 0x01, 0x06, 0x73, 0xb7, 0x2e};
+
+    assert_memory_equal(out, res, sizeof(res));
+    assert_true(check_input_commitment(session_key, 3, input, sizeof(input), out));
+
+    // Output too small
+    assert_false(calc_input_commitment(session_key, 3, input, sizeof(input), out, 31));
+}
+
+static void test_input_commitment_tampered(void **state) {
+    (void) state;
+
+    uint8_t session_key[INPUT_COMMITMENT_SESSION_LEN] = {0};
+    uint8_t input[46] = {0};
+    uint8_t commitment[INPUT_COMMITMENT_LEN] = {0};
+
+    fill_vector(session_key, input);
+
+    assert_true(calc_input_commitment(session_key,
+                                      3,
+                                      input,
+                                      sizeof(input),
+                                      commitment,
+                                      sizeof(commitment)));
+
+    // Same input claimed at another index
+    assert_false(check_input_commitment(session_key, 2, input, sizeof(input), commitment));
+    assert_false(check_input_commitment(session_key, 0x0103, input, sizeof(input), commitment));
+
+    // Changed value
+    input[40] ^= 0x01;
+    assert_false(check_input_commitment(session_key, 3, input, sizeof(input), commitment));
+    input[40] ^= 0x01;
+
+    // Commitment from another transaction
+    session_key[0] ^= 0x80;
+    assert_false(check_input_commitment(session_key, 3, input, sizeof(input), commitment));
+    session_key[0] ^= 0x80;
+
+    // Corrupted commitment
+    commitment[31] ^= 0x01;
+    assert_false(check_input_commitment(session_key, 3, input, sizeof(input), commitment));
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_input_commitment_vector),
+                                       cmocka_unit_test(test_input_commitment_tampered)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -71,6 +71,50 @@ static void test_hash_personal_message_vector0(void **state) {
     assert_memory_equal(out_hash, res, 32);
 }
 
+static void test_hash_personal_message_chunked(void **state) {
+    uint8_t message[1000] = {0};
+    uint8_t expected[32] = {0};
+    uint8_t out_hash[32] = {0};
+    hash_writer_t hash;
+
+    for (size_t i = 0; i < sizeof(message); i++) {
+        message[i] = (uint8_t) (i * 7 + 3);
+    }
+
+    assert_true(hash_personal_message(message, sizeof(message), expected, sizeof(expected)));
+
+    // Chunks that end before, on and after the 128 bytes BLAKE2b block boundaries
+    const size_t chunk_lens[] = {1, 127, 128, 129, 255, 1000};
+
+    for (size_t c = 0; c < sizeof(chunk_lens) / sizeof(chunk_lens[0]); c++) {
+        size_t offset = 0;
+
+        assert_true(personal_message_hash_init(&hash));
+        while (offset < sizeof(message)) {
+            size_t len = sizeof(message) - offset;
+            if (len > chunk_lens[c]) {
+                len = chunk_lens[c];
+            }
+            assert_true(personal_message_hash_update(&hash, message + offset, len));
+            offset += len;
+        }
+        assert_true(personal_message_hash_finalize(&hash, out_hash, sizeof(out_hash)));
+
+        assert_memory_equal(out_hash, expected, sizeof(expected));
+    }
+
+    // Same vector as the single APDU message
+    assert_true(personal_message_hash_init(&hash));
+    assert_true(personal_message_hash_update(&hash, (uint8_t *) "Hello ", 6));
+    assert_true(personal_message_hash_update(&hash, (uint8_t *) "Kaspa!", 6));
+    assert_true(personal_message_hash_finalize(&hash, out_hash, sizeof(out_hash)));
+    assert_true(hash_personal_message((uint8_t *) "Hello Kaspa!", 12, expected, sizeof(expected)));
+    assert_memory_equal(out_hash, expected, sizeof(expected));
+
+    assert_false(personal_message_hash_update(&hash, message, 0));
+    assert_false(personal_message_hash_finalize(&hash, out_hash, 31));
+}
+
 // static void test_sign_message_vector1(void **state) {
 //     uint8_t private_key_data[32] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
 //                                 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
@@ -101,7 +145,8 @@ static void test_hash_personal_message_vector0(void **state) {
 
 
 int main() {
-    const struct CMUnitTest tests[] = {cmocka_unit_test(test_hash_personal_message_vector0)};
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_hash_personal_message_vector0),
+                                       cmocka_unit_test(test_hash_personal_message_chunked)};
 
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -0,0 +1,171 @@
+/*****************************************************************************
+ * MIT License
+ *
+ * Copyright (c) 2023 coderofstuff
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *****************************************************************************/
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <cmocka.h>
+
+#include "pubkey_cache.h"
+
+static void make_pk_info(pubkey_ctx_t *pk_info, uint8_t seed) {
+    memset(pk_info->raw_public_key, seed, sizeof(pk_info->raw_public_key));
+    memset(pk_info->chain_code, seed ^ 0xFF, sizeof(pk_info->chain_code));
+}
+
+static void make_path(uint32_t *path, uint32_t address_index) {
+    path[0] = 0x8000002C;
+    path[1] = 0x8001b207;
+    path[2] = 0x80000000;
+    path[3] = 0;
+    path[4] = address_index;
+}
+
+static void test_pubkey_cache_hit_and_miss(void **state) {
+    uint32_t path[5] = {0};
+    pubkey_ctx_t pk_info = {0};
+    pubkey_ctx_t expected = {0};
+
+    pubkey_cache_clear();
+
+    make_path(path, 7);
+    make_pk_info(&expected, 0x07);
+
+    assert_false(pubkey_cache_get(path, 5, &pk_info));
+    pubkey_cache_put(path, 5, &expected);
+    assert_true(pubkey_cache_get(path, 5, &pk_info));
+    assert_memory_equal(&pk_info, &expected, sizeof(pk_info));
+
+    // Same levels but a shorter path is another key
+    assert_false(pubkey_cache_get(path, 4, &pk_info));
+
+    path[3] = 1;
+    assert_false(pubkey_cache_get(path, 5, &pk_info));
+
+    assert_int_equal(pubkey_cache_hits(), 1);
+    assert_int_equal(pubkey_cache_misses(), 3);
+}
+
+static void test_pubkey_cache_evicts_least_recently_used(void **state) {
+    uint32_t path[5] = {0};
+    pubkey_ctx_t pk_info = {0};
+    pubkey_ctx_t expected = {0};
+
+    pubkey_cache_clear();
+
+    for (uint32_t i = 0; i < PUBKEY_CACHE_LEN; i++) {
+        make_path(path, i);
+        make_pk_info(&pk_info, (uint8_t) i);
+        pubkey_cache_put(path, 5, &pk_info);
+    }
+
+    // Index 0 was added first but is used again, index 1 becomes the oldest
+    make_path(path, 0);
+    assert_true(pubkey_cache_get(path, 5, &pk_info));
+
+    make_path(path, PUBKEY_CACHE_LEN);
+    make_pk_info(&pk_info, PUBKEY_CACHE_LEN);
+    pubkey_cache_put(path, 5, &pk_info);
+
+    make_path(path, 1);
+    assert_false(pubkey_cache_get(path, 5, &pk_info));
+
+    for (uint32_t i = 0; i <= PUBKEY_CACHE_LEN; i++) {
+        if (i == 1) {
+            continue;
+        }
+        make_path(path, i);
+        make_pk_info(&expected, (uint8_t) i);
+        assert_true(pubkey_cache_get(path, 5, &pk_info));
+        assert_memory_equal(&pk_info, &expected, sizeof(pk_info));
+    }
+}
+
+static void test_pubkey_cache_put_existing_path(void **state) {
+    uint32_t path[5] = {0};
+    uint32_t other[5] = {0};
+    pubkey_ctx_t pk_info = {0};
+    pubkey_ctx_t expected = {0};
+
+    pubkey_cache_clear();
+
+    make_path(path, 3);
+    make_pk_info(&pk_info, 0x01);
+    pubkey_cache_put(path, 5, &pk_info);
+
+    // Putting the same path again replaces its entry, it doesn't take another one
+    make_pk_info(&expected, 0x02);
+    pubkey_cache_put(path, 5, &expected);
+    for (uint32_t i = 0; i < PUBKEY_CACHE_LEN - 1; i++) {
+        make_path(other, 100 + i);
+        pubkey_cache_put(other, 5, &pk_info);
+    }
+
+    assert_true(pubkey_cache_get(path, 5, &pk_info));
+    assert_memory_equal(&pk_info, &expected, sizeof(pk_info));
+}
+
+static void test_pubkey_cache_clear(void **state) {
+    uint32_t path[5] = {0};
+    pubkey_ctx_t pk_info = {0};
+
+    pubkey_cache_clear();
+
+    make_path(path, 0);
+    make_pk_info(&pk_info, 0x42);
+    pubkey_cache_put(path, 5, &pk_info);
+    assert_true(pubkey_cache_get(path, 5, &pk_info));
+
+    pubkey_cache_clear();
+
+    assert_int_equal(pubkey_cache_hits(), 0);
+    assert_int_equal(pubkey_cache_misses(), 0);
+    assert_false(pubkey_cache_get(path, 5, &pk_info));
+}
+
+static void test_pubkey_cache_rejects_bad_length(void **state) {
+    uint32_t path[KASPA_MAX_BIP32_PATH_LEN + 1] = {0};
+    pubkey_ctx_t pk_info = {0};
+
+    pubkey_cache_clear();
+
+    pubkey_cache_put(path, 0, &pk_info);
+    pubkey_cache_put(path, KASPA_MAX_BIP32_PATH_LEN + 1, &pk_info);
+
+    assert_false(pubkey_cache_get(path, 0, &pk_info));
+    assert_false(pubkey_cache_get(path, KASPA_MAX_BIP32_PATH_LEN + 1, &pk_info));
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {cmocka_unit_test(test_pubkey_cache_hit_and_miss),
+                                       cmocka_unit_test(test_pubkey_cache_evicts_least_recently_used),
+                                       cmocka_unit_test(test_pubkey_cache_put_existing_path),
+                                       cmocka_unit_test(test_pubkey_cache_clear),
+                                       cmocka_unit_test(test_pubkey_cache_rejects_bad_length)};
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -89,17 +89,23 @@ static void test_sighash(void **state) {
     txin.index = 1;
     txin.value = 2;
 
-    memcpy(txout.script_public_key, output_script_public_key, sizeof(output_script_public_key));
     txout.value = txin.value; // Assume no fee
 
     tx.version = 1;
     tx.tx_inputs[0] = txin;
     tx.tx_input_len = 1;
-    tx.tx_outputs[0] = txout;
+    tx.tx_output_values[0] = txout.value;
+    memcpy(tx.tx_scripts.data, output_script_public_key, sizeof(output_script_public_key));
+    tx.tx_scripts.len = sizeof(output_script_public_key);
+    tx.tx_output_script_offsets[0] = 0;
+    tx.tx_output_script_lens[0] = sizeof(output_script_public_key);
     tx.tx_output_len = 1;
 
+    sighash_cache_t cache;
+    assert_true(calc_sighash_cache(&tx, &cache));
+
     uint8_t out_hash[32] = {0};
-    bool success = calc_sighash(&tx, &txin, input_public_key_data, out_hash, sizeof(out_hash));
+    bool success = calc_sighash(&cache, &txin, input_public_key_data, out_hash, sizeof(out_hash));
 
     uint8_t res[32] = {0x7c, 0xcd, 0xa6, 0xc6, 0x4a, 0x18, 0x1e, 0x62,
                        0x63, 0xf0, 0xee, 0xe2, 0xed, 0xc8, 0x59, 0xdb,
@@ -142,17 +148,23 @@ static void test_sighash_zeros(void **state) {
     txin.index = 0;
     txin.value = 0;
 
-    memcpy(txout.script_public_key, output_script_public_key, sizeof(output_script_public_key));
     txout.value = txin.value; // Assume no fee
 
     tx.version = 0;
     tx.tx_inputs[0] = txin;
     tx.tx_input_len = 1;
-    tx.tx_outputs[0] = txout;
+    tx.tx_output_values[0] = txout.value;
+    memcpy(tx.tx_scripts.data, output_script_public_key, sizeof(output_script_public_key));
+    tx.tx_scripts.len = sizeof(output_script_public_key);
+    tx.tx_output_script_offsets[0] = 0;
+    tx.tx_output_script_lens[0] = sizeof(output_script_public_key);
     tx.tx_output_len = 1;
 
+    sighash_cache_t cache;
+    assert_true(calc_sighash_cache(&tx, &cache));
+
     uint8_t out_hash[32] = {0};
-    bool success = calc_sighash(&tx, &txin, input_public_key_data, out_hash, sizeof(out_hash));
+    bool success = calc_sighash(&cache, &txin, input_public_key_data, out_hash, sizeof(out_hash));
 
     uint8_t res[32] = {0x61, 0x2d, 0x56, 0xe6, 0x33, 0xee, 0x5d, 0xa1,
                        0xca, 0xa4, 0x56, 0x3c, 0x6a, 0xce, 0x0c, 0x98,
@@ -163,9 +175,163 @@ static void test_sighash_zeros(void **state) {
     assert_true(success);
 }
 
+static uint8_t multiple_inputs_public_key[32] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+                                                 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+                                                 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+                                                 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20};
+
+static uint8_t multiple_inputs_res[2][32] = {{0x6d, 0x4f, 0x53, 0x3c, 0xbb, 0x7c, 0x04, 0x54,
+                                              0xa0, 0x79, 0x15, 0xb0, 0x95, 0x2a, 0x15, 0x4f,
+                                              0x9d, 0x3a, 0xba, 0x6b, 0xc9, 0xe2, 0x38, 0xe4,
+                                              0x21, 0x3e, 0xe6, 0x0c, 0xad, 0xf9, 0x7c, 0x4a},
+                                             {0xa9, 0xf0, 0x9f, 0x3f, 0x0b, 0xf8, 0x09, 0xe8,
+                                              0xb7, 0x86, 0x43, 0x1c, 0x63, 0x65, 0xf1, 0x15,
+                                              0xb8, 0xd5, 0x28, 0x8e, 0xda, 0xb8, 0x52, 0xca,
+                                              0xc9, 0xa1, 0xdb, 0x57, 0x4e, 0x4b, 0x8b, 0x46}};
+
+static void fill_multiple_inputs_tx(transaction_t *tx) {
+    memset(tx, 0, sizeof(*tx));
+
+    tx->version = 0;
+    tx->tx_input_len = 2;
+    tx->tx_output_len = 2;
+
+    for (size_t i = 0; i < tx->tx_input_len; i++) {
+        memset(tx->tx_inputs[i].tx_id, (int) i, 32);
+        tx->tx_inputs[i].index = i;
+        tx->tx_inputs[i].value = 1000 + i;
+    }
+
+    uint8_t *scripts = tx->tx_scripts.data;
+
+    tx->tx_output_values[0] = 1500;
+    tx->tx_output_script_offsets[0] = 0;
+    tx->tx_output_script_lens[0] = 34;
+    scripts[0] = 0x20;
+    memset(scripts + 1, 0xc6, 32);
+    scripts[33] = OP_CHECKSIG;
+
+    tx->tx_output_values[1] = 400;
+    tx->tx_output_script_offsets[1] = 34;
+    tx->tx_output_script_lens[1] = 35;
+    scripts[34] = OP_BLAKE2B;
+    scripts[35] = 0x20;
+    memset(scripts + 36, 0xab, 32);
+    scripts[68] = OP_EQUAL;
+
+    tx->tx_scripts.len = 69;
+}
+
+static void test_sighash_multiple_inputs(void **state) {
+    transaction_t tx;
+    fill_multiple_inputs_tx(&tx);
+
+    // The same cache must be reusable for every input of the transaction
+    sighash_cache_t cache;
+    assert_true(calc_sighash_cache(&tx, &cache));
+
+    for (size_t i = 0; i < tx.tx_input_len; i++) {
+        uint8_t out_hash[32] = {0};
+        bool success = calc_sighash(&cache,
+                                    &tx.tx_inputs[i],
+                                    multiple_inputs_public_key,
+                                    out_hash,
+                                    sizeof(out_hash));
+
+        assert_true(success);
+        assert_memory_equal(out_hash, multiple_inputs_res[i], 32);
+    }
+}
+
+static void test_sighash_streamed(void **state) {
+    transaction_t tx;
+    fill_multiple_inputs_tx(&tx);
+
+    // Only the inputs are written as they arrive, the outputs are hashed
+    // from the transaction once it is complete
+    sighash_cache_t cache;
+    assert_true(sighash_cache_start(&cache));
+    assert_true(sighash_cache_add_input(&cache, &tx.tx_inputs[0]));
+    assert_true(sighash_cache_add_input(&cache, &tx.tx_inputs[1]));
+    assert_true(sighash_cache_finish(&tx, &cache));
+
+    for (size_t i = 0; i < tx.tx_input_len; i++) {
+        uint8_t out_hash[32] = {0};
+        bool success = calc_sighash(&cache,
+                                    &tx.tx_inputs[i],
+                                    multiple_inputs_public_key,
+                                    out_hash,
+                                    sizeof(out_hash));
+
+        assert_true(success);
+        assert_memory_equal(out_hash, multiple_inputs_res[i], 32);
+    }
+}
+
+static void test_sighash_all_vectors(void **state) {
+    transaction_t tx;
+    fill_multiple_inputs_tx(&tx);
+
+    uint8_t pubkeys[2][32];
+    memcpy(pubkeys[0], multiple_inputs_public_key, 32);
+    memcpy(pubkeys[1], multiple_inputs_public_key, 32);
+
+    // The caller's cache is what the digests are written to
+    sighash_cache_t cache;
+    memset(&cache, 0, sizeof(cache));
+
+    uint8_t out[2][32] = {0};
+    assert_true(calc_sighash_all(&tx, &cache, (const uint8_t(*)[32]) pubkeys, out));
+
+    assert_memory_equal(out[0], multiple_inputs_res[0], 32);
+    assert_memory_equal(out[1], multiple_inputs_res[1], 32);
+
+    sighash_cache_t expected;
+    assert_true(calc_sighash_cache(&tx, &expected));
+    assert_memory_equal(cache.outputs_hash, expected.outputs_hash, 32);
+    assert_memory_equal(cache.prev_outputs_hash, expected.prev_outputs_hash, 32);
+}
+
+static void test_sighash_all(void **state) {
+    static transaction_t tx;
+    static uint8_t pubkeys[MAX_INPUT_COUNT][32];
+    static uint8_t out[MAX_INPUT_COUNT][32];
+
+    for (size_t i = 0; i < MAX_INPUT_COUNT; i++) {
+        memset(pubkeys[i], (int) (i + 1), 32);
+    }
+
+    for (size_t input_len = 1; input_len <= MAX_INPUT_COUNT; input_len++) {
+        fill_multiple_inputs_tx(&tx);
+        tx.tx_input_len = input_len;
+        for (size_t i = 0; i < input_len; i++) {
+            memset(tx.tx_inputs[i].tx_id, (int) i, 32);
+            tx.tx_inputs[i].index = (uint8_t) i;
+            tx.tx_inputs[i].value = 1000 + i;
+        }
+
+        sighash_cache_t cache;
+        memset(out, 0, sizeof(out));
+        assert_true(calc_sighash_all(&tx, &cache, (const uint8_t(*)[32]) pubkeys, out));
+
+        assert_true(calc_sighash_cache(&tx, &cache));
+
+        for (size_t i = 0; i < input_len; i++) {
+            uint8_t out_hash[32] = {0};
+            assert_true(
+                calc_sighash(&cache, &tx.tx_inputs[i], pubkeys[i], out_hash, sizeof(out_hash)));
+            assert_memory_equal(out[i], out_hash, 32);
+        }
+    }
+}
+
 int main() {
     const struct CMUnitTest tests[] = {cmocka_unit_test(test_sighash),
-                                       cmocka_unit_test(test_sighash_zeros)};
+                                       cmocka_unit_test(test_sighash_zeros),
+                                       cmocka_unit_test(test_sighash_multiple_inputs),
+                                       cmocka_unit_test(test_sighash_streamed),
+                                       cmocka_unit_test(test_sighash_all_vectors),
+                                       cmocka_unit_test(test_sighash_all)};
 
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
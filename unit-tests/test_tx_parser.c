@@ -89,7 +89,11 @@ static void test_tx_deserialization_fail(void **state) {
     };
 
     uint8_t invalid_outlen[] = {
-        0x00, 0x01, 0x03
+        0x00, 0x01, MAX_OUTPUT_COUNT + 1
+    };
+
+    uint8_t no_outputs[] = {
+        0x00, 0x01, 0x00
     };
 
     uint8_t missing_inlen[] = {
@@ -119,6 +123,7 @@ static void test_tx_deserialization_fail(void **state) {
     assert_int_equal(run_test_tx_serialize(invalid_version, sizeof(invalid_version)), VERSION_PARSING_ERROR);
     assert_int_equal(run_test_tx_serialize(missing_outlen, sizeof(missing_outlen)), OUTPUTS_LENGTH_PARSING_ERROR);
     assert_int_equal(run_test_tx_serialize(invalid_outlen, sizeof(invalid_outlen)), OUTPUTS_LENGTH_PARSING_ERROR);
+    assert_int_equal(run_test_tx_serialize(no_outputs, sizeof(no_outputs)), OUTPUTS_LENGTH_PARSING_ERROR);
     assert_int_equal(run_test_tx_serialize(missing_inlen, sizeof(missing_inlen)), INPUTS_LENGTH_PARSING_ERROR);
     assert_int_equal(run_test_tx_serialize(invalid_inlen, sizeof(invalid_inlen)), INPUTS_LENGTH_PARSING_ERROR);
     assert_int_equal(run_test_tx_serialize(invalid_change_type, sizeof(invalid_change_type)), HEADER_PARSING_ERROR);
@@ -127,6 +132,81 @@ static void test_tx_deserialization_fail(void **state) {
     assert_int_equal(run_test_tx_serialize(invalid_account_too_low, sizeof(invalid_change_type)), HEADER_PARSING_ERROR);
 }
 
+static void test_tx_deserialization_streamed(void **state) {
+    (void) state;
+
+    transaction_t tx;
+
+    uint32_t path[KASPA_MAX_BIP32_PATH_LEN] = {0};
+
+    // clang-format off
+    uint8_t raw_tx[] = {
+        // header, the input count takes 2 bytes
+        0x00, 0x01, 0x02, 0x01, 0x2C,
+        0x01,
+        0x04, 0x05, 0x06, 0xFF,
+        0x80, 0x00, 0x00, 0x00
+    };
+
+    uint8_t no_inputs[] = {
+        0x00, 0x01, 0x02, 0x00, 0x00
+    };
+
+    uint8_t missing_inlen[] = {
+        0x00, 0x01, 0x02, 0x01
+    };
+
+    // One more than the 128 * 48 * 8 bits of the input storage
+    uint8_t too_many_inputs[] = {
+        0x00, 0x01, 0x02, 0xC0, 0x01,
+        0x01,
+        0x04, 0x05, 0x06, 0xFF,
+        0x80, 0x00, 0x00, 0x00
+    };
+
+    buffer_t buf = {.ptr = raw_tx, .size = sizeof(raw_tx), .offset = 0};
+
+    parser_status_e status = transaction_deserialize_streamed(&buf, &tx, path);
+
+    assert_int_equal(status, PARSING_OK);
+    assert_int_equal(tx.version, 1);
+    assert_int_equal(tx.tx_output_len, 2);
+    // More than MAX_INPUT_COUNT, they are not stored
+    assert_int_equal(tx.tx_input_len, 300);
+
+    buf = (buffer_t) {.ptr = no_inputs, .size = sizeof(no_inputs), .offset = 0};
+    assert_int_equal(transaction_deserialize_streamed(&buf, &tx, path), INPUTS_LENGTH_PARSING_ERROR);
+
+    buf = (buffer_t) {.ptr = missing_inlen, .size = sizeof(missing_inlen), .offset = 0};
+    assert_int_equal(transaction_deserialize_streamed(&buf, &tx, path), INPUTS_LENGTH_PARSING_ERROR);
+
+    buf = (buffer_t) {.ptr = too_many_inputs, .size = sizeof(too_many_inputs), .offset = 0};
+    assert_int_equal(transaction_deserialize_streamed(&buf, &tx, path), INPUTS_LENGTH_PARSING_ERROR);
+}
+
+static void test_tx_deserialization_many_outputs(void **state) {
+    (void) state;
+
+    transaction_t tx;
+
+    uint32_t path[KASPA_MAX_BIP32_PATH_LEN] = {0};
+
+    // clang-format off
+    uint8_t raw_tx[] = {
+        // header, as many outputs as can be stored
+        0x00, 0x01, MAX_OUTPUT_COUNT, 0x03,
+        0x01,
+        0x04, 0x05, 0x06, 0xFF,
+        0x80, 0x00, 0x00, 0x00
+    };
+
+    buffer_t buf = {.ptr = raw_tx, .size = sizeof(raw_tx), .offset = 0};
+
+    assert_int_equal(transaction_deserialize(&buf, &tx, path), PARSING_OK);
+    assert_int_equal(tx.tx_output_len, MAX_OUTPUT_COUNT);
+    assert_int_equal(tx.tx_input_len, 3);
+}
+
 static void test_tx_input_serialization(void **state) {
         (void) state;
 
@@ -215,10 +295,52 @@ static void test_tx_input_deserialization_fail(void **state) {
     assert_int_equal(run_test_tx_input_serialize(invalid_index, sizeof(invalid_index)), INPUT_INDEX_PARSING_ERROR);
 }
 
+static void test_tx_input_deserialization_record(void **state) {
+    (void) state;
+
+    uint8_t record[SERIALIZED_INPUT_LEN + 1] = {0};
+    transaction_input_t expected;
+    transaction_input_t txin;
+    uint32_t seed = 0x4b415350;
+
+    // transaction_input_deserialize is the reference, the fast path must
+    // decode any record the same way
+    for (size_t round = 0; round < 1000; round++) {
+        for (size_t i = 0; i < SERIALIZED_INPUT_LEN; i++) {
+            seed = seed * 1103515245 + 12345;
+            record[i] = (uint8_t) (seed >> 16);
+        }
+
+        buffer_t buf = {.ptr = record, .size = SERIALIZED_INPUT_LEN, .offset = 0};
+        assert_int_equal(transaction_input_deserialize(&buf, &expected), PARSING_OK);
+        assert_int_equal(transaction_input_deserialize_record(record, SERIALIZED_INPUT_LEN, &txin),
+                         PARSING_OK);
+
+        assert_int_equal(txin.value, expected.value);
+        assert_memory_equal(txin.tx_id, expected.tx_id, sizeof(txin.tx_id));
+        assert_int_equal(txin.address_type, expected.address_type);
+        assert_int_equal(txin.address_index, expected.address_index);
+        assert_int_equal(txin.index, expected.index);
+    }
+
+    // Both reject a record that is too short or too long
+    for (size_t len = 0; len <= SERIALIZED_INPUT_LEN + 1; len++) {
+        if (len == SERIALIZED_INPUT_LEN) {
+            continue;
+        }
+
+        buffer_t buf = {.ptr = record, .size = len, .offset = 0};
+        assert_true(transaction_input_deserialize(&buf, &expected) < 0);
+        assert_int_equal(transaction_input_deserialize_record(record, len, &txin),
+                         INPUT_PARSING_ERROR);
+    }
+}
+
 static void test_tx_output_serialization_32_bytes(void **state) {
         (void) state;
 
     transaction_output_t txout;
+    script_arena_t scripts = {0};
 
     // clang-format off
     uint8_t raw_tx[] = {
@@ -234,12 +356,12 @@ static void test_tx_output_serialization_32_bytes(void **state) {
 
     buffer_t buf = {.ptr = raw_tx, .size = sizeof(raw_tx), .offset = 0};
 
-    parser_status_e status = transaction_output_deserialize(&buf, &txout);
+    parser_status_e status = transaction_output_deserialize(&buf, &txout, &scripts);
 
     assert_int_equal(status, PARSING_OK);
 
     uint8_t output[350];
-    int length = transaction_output_serialize(&txout, output, sizeof(output));
+    int length = transaction_output_serialize(&txout, &scripts, output, sizeof(output));
     assert_int_equal(length, sizeof(raw_tx));
     assert_memory_equal(raw_tx, output, sizeof(raw_tx));
 }
@@ -248,6 +370,7 @@ static void test_tx_output_serialization_33_bytes(void **state) {
         (void) state;
 
     transaction_output_t txout;
+    script_arena_t scripts = {0};
 
     // clang-format off
     uint8_t raw_tx[] = {
@@ -263,12 +386,12 @@ static void test_tx_output_serialization_33_bytes(void **state) {
 
     buffer_t buf = {.ptr = raw_tx, .size = sizeof(raw_tx), .offset = 0};
 
-    parser_status_e status = transaction_output_deserialize(&buf, &txout);
+    parser_status_e status = transaction_output_deserialize(&buf, &txout, &scripts);
 
     assert_int_equal(status, PARSING_OK);
 
     uint8_t output[350];
-    int length = transaction_output_serialize(&txout, output, sizeof(output));
+    int length = transaction_output_serialize(&txout, &scripts, output, sizeof(output));
     assert_int_equal(length, sizeof(raw_tx));
     assert_memory_equal(raw_tx, output, sizeof(raw_tx));
 }
@@ -277,6 +400,7 @@ static void test_tx_output_serialization_p2sh(void **state) {
         (void) state;
 
     transaction_output_t txout;
+    script_arena_t scripts = {0};
 
     // clang-format off
     uint8_t raw_tx[] = {
@@ -292,22 +416,92 @@ static void test_tx_output_serialization_p2sh(void **state) {
 
     buffer_t buf = {.ptr = raw_tx, .size = sizeof(raw_tx), .offset = 0};
 
-    parser_status_e status = transaction_output_deserialize(&buf, &txout);
+    parser_status_e status = transaction_output_deserialize(&buf, &txout, &scripts);
 
     assert_int_equal(status, PARSING_OK);
 
     uint8_t output[350];
-    int length = transaction_output_serialize(&txout, output, sizeof(output));
+    int length = transaction_output_serialize(&txout, &scripts, output, sizeof(output));
     assert_int_equal(length, sizeof(raw_tx));
     assert_memory_equal(raw_tx, output, sizeof(raw_tx));
 }
 
 static int run_test_tx_output_serialize(uint8_t* raw_tx, size_t raw_tx_len) {
     transaction_output_t txout;
+    script_arena_t scripts = {0};
 
     buffer_t buf = {.ptr = raw_tx, .size = raw_tx_len, .offset = 0};
 
-    return transaction_output_deserialize(&buf, &txout);
+    parser_status_e status = transaction_output_deserialize(&buf, &txout, &scripts);
+
+    // A rejected output must not take any room in the arena
+    if (status != PARSING_OK) {
+        assert_int_equal(scripts.len, 0);
+    }
+
+    return status;
+}
+
+static void test_tx_output_script_arena(void **state) {
+    (void) state;
+
+    transaction_output_t txout;
+    script_arena_t scripts = {0};
+
+    // clang-format off
+    uint8_t schnorr[] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x86, 0xa0,
+        0x20,
+        0xe1, 0x19, 0xd5, 0x35, 0x14, 0xc1, 0xb0, 0xe2,
+        0xef, 0xce, 0x7a, 0x89, 0xe3, 0xd1, 0xd5, 0xd6,
+        0xcd, 0x73, 0x58, 0x2e, 0xa2, 0x06, 0x87, 0x64,
+        0x1c, 0x8f, 0xdc, 0xcb, 0x60, 0x60, 0xa9, 0xad,
+        OP_CHECKSIG
+    };
+
+    uint8_t p2sh[] = {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xe8,
+        OP_BLAKE2B, 0x20,
+        0xe1, 0x19, 0xd5, 0x35, 0x14, 0xc1, 0xb0, 0xe2,
+        0xef, 0xce, 0x7a, 0x89, 0xe3, 0xd1, 0xd5, 0xd6,
+        0xcd, 0x73, 0x58, 0x2e, 0xa2, 0x06, 0x87, 0x64,
+        0x1c, 0x8f, 0xdc, 0xcb, 0x60, 0x60, 0xa9, 0xad,
+        OP_EQUAL
+    };
+    // clang-format on
+
+    // Scripts are appended one after the other
+    buffer_t buf = {.ptr = schnorr, .size = sizeof(schnorr), .offset = 0};
+    assert_int_equal(transaction_output_deserialize(&buf, &txout, &scripts), PARSING_OK);
+    assert_int_equal(txout.script_offset, 0);
+    assert_int_equal(txout.script_len, 34);
+
+    buf = (buffer_t){.ptr = p2sh, .size = sizeof(p2sh), .offset = 0};
+    assert_int_equal(transaction_output_deserialize(&buf, &txout, &scripts), PARSING_OK);
+    assert_int_equal(txout.value, 1000);
+    assert_int_equal(txout.script_offset, 34);
+    assert_int_equal(txout.script_len, 35);
+    assert_int_equal(scripts.len, 69);
+    assert_memory_equal(scripts.data, schnorr + 8, 34);
+    assert_memory_equal(scripts.data + 34, p2sh + 8, 35);
+
+    // Nothing is copied for a rejected output
+    uint8_t trailing[sizeof(schnorr) + 1] = {0};
+    memcpy(trailing, schnorr, sizeof(schnorr));
+    buf = (buffer_t){.ptr = trailing, .size = sizeof(trailing), .offset = 0};
+    assert_int_equal(transaction_output_deserialize(&buf, &txout, &scripts), OUTPUT_PARSING_ERROR);
+    assert_int_equal(scripts.len, 69);
+
+    // A script that does not fit in what is left of the arena is rejected
+    scripts.len = sizeof(scripts.data) - 34;
+    buf = (buffer_t){.ptr = p2sh, .size = sizeof(p2sh), .offset = 0};
+    assert_int_equal(transaction_output_deserialize(&buf, &txout, &scripts),
+                     OUTPUT_SCRIPT_PUBKEY_PARSING_ERROR);
+    assert_int_equal(scripts.len, sizeof(scripts.data) - 34);
+
+    buf = (buffer_t){.ptr = schnorr, .size = sizeof(schnorr), .offset = 0};
+    assert_int_equal(transaction_output_deserialize(&buf, &txout, &scripts), PARSING_OK);
+    assert_int_equal(scripts.len, sizeof(scripts.data));
 }
 
 static void test_tx_output_deserialization_fail(void **state) {
@@ -400,26 +594,31 @@ static void test_tx_output_deserialization_fail(void **state) {
 
 static void test_serialization_fail(void **state) {
     transaction_t tx;
-    transaction_output_t txout;
+    transaction_output_t txout = {0};
+    script_arena_t scripts = {0};
     transaction_input_t txin;
 
     uint8_t buffer[1] = {0};
     uint32_t path[KASPA_MAX_BIP32_PATH_LEN] = {0};
 
     assert_int_equal(transaction_serialize(&tx, path, buffer, sizeof(buffer)), -1);
-    assert_int_equal(transaction_output_serialize(&txout, buffer, sizeof(buffer)), -1);
+    assert_int_equal(transaction_output_serialize(&txout, &scripts, buffer, sizeof(buffer)), -1);
     assert_int_equal(transaction_input_serialize(&txin, buffer, sizeof(buffer)), -1);
 }
 
 int main() {
     const struct CMUnitTest tests[] = {cmocka_unit_test(test_tx_serialization),
                                        cmocka_unit_test(test_tx_deserialization_fail),
+                                       cmocka_unit_test(test_tx_deserialization_streamed),
+                                       cmocka_unit_test(test_tx_deserialization_many_outputs),
                                        cmocka_unit_test(test_tx_input_serialization),
                                        cmocka_unit_test(test_tx_input_deserialization_fail),
+                                       cmocka_unit_test(test_tx_input_deserialization_record),
                                        cmocka_unit_test(test_tx_output_serialization_32_bytes),
                                        cmocka_unit_test(test_tx_output_serialization_33_bytes),
                                        cmocka_unit_test(test_tx_output_serialization_p2sh),
                                        cmocka_unit_test(test_tx_output_deserialization_fail),
+                                       cmocka_unit_test(test_tx_output_script_arena),
                                        cmocka_unit_test(test_serialization_fail)};
 
     return cmocka_run_group_tests(tests, NULL, NULL);
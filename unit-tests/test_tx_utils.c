@@ -109,25 +109,104 @@ static void test_calc_fees(void **state) {
     (void) state;
 
     // clang-format off
-    transaction_output_t txout[1] = {0};
-    transaction_input_t txin[2] = {0};
+    uint64_t input_total = 0;
+    uint64_t output_total = 0;
 
-    txin[0].value = (uint64_t)  0xFFFFFFFFFFFFFF00;
-    txin[1].value = (uint64_t)  0x00000000000000FF;
-    // Total:                   0xFFFFFFFFFFFFFFFF
-    txout[0].value = (uint64_t) 0xFFFFFFFFFFFFF00F;
-    // Difference:              0x0000000000000FF0
+    assert_true(add_to_total(&input_total, (uint64_t) 0xFFFFFFFFFFFFFF00));
+    assert_true(add_to_total(&input_total, (uint64_t) 0x00000000000000FF));
+    // Total:                                         0xFFFFFFFFFFFFFFFF
+    assert_true(add_to_total(&output_total, (uint64_t) 0xFFFFFFFFFFFFF00F));
+    // Difference:                                    0x0000000000000FF0
 
-    uint64_t fees = calc_fees(txin, 2, txout, 1);
+    uint64_t fees = calc_fees(input_total, output_total);
     uint64_t expected_fee = (uint64_t) 0x00000000000FF0;
 
     assert_true(fees == expected_fee);
+
+    // Outputs worth more than the inputs are rejected by validation
+    assert_true(calc_fees(0x0000000000001000, 0x0000000000001001) == 0);
+}
+
+static void test_add_to_total(void **state) {
+    (void) state;
+
+    uint64_t total = 0;
+
+    assert_true(add_to_total(&total, (uint64_t) 0x0000000000000F00));
+    assert_true(add_to_total(&total, (uint64_t) 0x000000000000000F));
+    assert_true(total == (uint64_t) 0x0000000000000F0F);
+
+    // A sum that wraps around is refused and the total is left as is
+    total = (uint64_t) 0xFFFFFFFFFFFFFF00;
+    assert_false(add_to_total(&total, (uint64_t) 0x0000000000000100));
+    assert_true(total == (uint64_t) 0xFFFFFFFFFFFFFF00);
+
+    assert_true(add_to_total(&total, (uint64_t) 0x00000000000000FF));
+    assert_true(total == UINT64_MAX);
+    assert_false(add_to_total(&total, 1));
+    assert_true(add_to_total(&total, 0));
+}
+
+static void test_count_recipient_outputs(void **state) {
+    (void) state;
+
+    transaction_t tx = {0};
+
+    // A single output pays someone else
+    tx.tx_output_len = 1;
+    assert_int_equal(count_recipient_outputs(&tx), 1);
+
+    // The last output is the change
+    tx.tx_output_len = 2;
+    assert_int_equal(count_recipient_outputs(&tx), 1);
+
+    tx.tx_output_len = MAX_OUTPUT_COUNT;
+    assert_int_equal(count_recipient_outputs(&tx), MAX_OUTPUT_COUNT - 1);
+}
+
+static void test_group_inputs_by_path(void **state) {
+    (void) state;
+
+    transaction_input_t txin[6] = {0};
+    uint8_t order[6] = {0};
+
+    // Paths: A B A C B A, where B shares the index of A but not its type
+    txin[0].address_type = 0;
+    txin[0].address_index = 5;
+    txin[1].address_type = 1;
+    txin[1].address_index = 5;
+    txin[2].address_type = 0;
+    txin[2].address_index = 5;
+    txin[3].address_type = 0;
+    txin[3].address_index = 7;
+    txin[4].address_type = 1;
+    txin[4].address_index = 5;
+    txin[5].address_type = 0;
+    txin[5].address_index = 5;
+
+    group_inputs_by_path(txin, 6, order);
+
+    const uint8_t expected[6] = {0, 2, 5, 1, 4, 3};
+    assert_memory_equal(order, expected, sizeof(expected));
+
+    // All distinct: same order as received
+    txin[2].address_index = 6;
+    txin[4].address_index = 8;
+    txin[5].address_index = 9;
+
+    group_inputs_by_path(txin, 6, order);
+
+    const uint8_t unchanged[6] = {0, 1, 2, 3, 4, 5};
+    assert_memory_equal(order, unchanged, sizeof(unchanged));
 }
 
 int main() {
     const struct CMUnitTest tests[] = {cmocka_unit_test(test_tx_utils),
                                        cmocka_unit_test(test_script_public_key_to_address),
-                                       cmocka_unit_test(test_calc_fees)};
+                                       cmocka_unit_test(test_calc_fees),
+                                       cmocka_unit_test(test_add_to_total),
+                                       cmocka_unit_test(test_count_recipient_outputs),
+                                       cmocka_unit_test(test_group_inputs_by_path)};
 
     return cmocka_run_group_tests(tests, NULL, NULL);
 }